@@ -5,6 +5,7 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../src/fa.cpp \
+../src/multifa.cpp \
 ../src/ndfa.cpp \
 ../src/reachable.cpp \
 ../src/runoffvoting.cpp \
@@ -12,6 +13,7 @@ CPP_SRCS += \
 
 OBJS += \
 ./src/fa.o \
+./src/multifa.o \
 ./src/ndfa.o \
 ./src/reachable.o \
 ./src/runoffvoting.o \
@@ -19,6 +21,7 @@ OBJS += \
 
 CPP_DEPS += \
 ./src/fa.d \
+./src/multifa.d \
 ./src/ndfa.d \
 ./src/reachable.d \
 ./src/runoffvoting.d \
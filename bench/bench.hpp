@@ -0,0 +1,209 @@
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include "string_pool.hpp"
+
+
+//Benchmark harness shared by the bench_*.cpp files.
+//Each bench_*.cpp includes one program from ../src with DS_NO_MAIN defined (so
+//  its main() is left out) and registers timings for that program's functions.
+//Results are written one JSON object per line, so two runs can be compared with
+//  any line-oriented tool (sort, join, jq, a spreadsheet, ...).
+namespace ds {
+namespace bench {
+
+
+//Settings from the command line, shared by every benchmark.
+//The workload sizes marked * are multiplied by scale; the others are used as
+//  given.
+struct Config {
+	int         scale      = 1;      //multiplies every * workload size
+	int         iterations = 20;     //timed repetitions per benchmark
+	int         warmup     = 2;      //untimed repetitions before timing starts
+	std::uint64_t seed     = 12345;  //same seed + same sizes = same input files
+	std::string dir        = "/tmp"; //where generated input files are written
+	std::string filter;              //run only benchmarks whose name contains this
+
+	int states     = 32;     //* fa, ndfa: states in each automaton
+	int inputs     = 8;      //  fa, ndfa: size of the input alphabet
+	int fanout     = 3;      //  ndfa: most transitions per state and input
+	int lines      = 200;    //* fa, ndfa: simulation descriptions
+	int length     = 50;     //  fa, ndfa: inputs per description
+	int automata   = 4;      //  fa: automata run over the same descriptions
+	int nodes      = 500;    //* reachable: nodes in the graph
+	int edges      = 2000;   //* reachable: edges in the graph
+	int starts     = 20;     //  reachable: start nodes (those with the most edges)
+	int voters     = 500;    //* runoffvoting: ballots
+	int candidates = 10;     //  runoffvoting: candidates on each ballot
+	int words      = 2000;   //* wordgenerator: words in the corpus
+	int vocabulary = 200;    //  wordgenerator: distinct words
+	int os         = 2;      //  wordgenerator: order statistic
+};
+
+
+//Latency summary for one benchmark: every iteration performs ops operations
+//  (process() calls, reachable() calls, lines parsed, ...).
+//ns holds one latency sample per operation for benchmarks timed with run_each,
+//  but one per iteration (a whole call, e.g. reading a file) for benchmarks
+//  timed with run; sample says which.
+struct Result {
+	std::string name;
+	int         scale;
+	int         iterations;
+	long        ops;                //operations per iteration
+	const char* sample;             //"op" or "call"
+	std::int64_t total_ns = 0;      //time spent in all the timed operations
+	std::vector<std::int64_t> ns;   //latency samples, sorted
+
+	//Nearest-rank percentile of the samples
+	std::int64_t percentile(double p) const {
+		if (ns.empty())
+			return 0;
+		std::size_t rank = std::size_t(std::ceil(p/100.0*ns.size()));
+		return ns[rank == 0 ? 0 : rank-1];
+	}
+
+	double ops_per_sec() const {
+		return total_ns == 0 ? 0.0 : double(ops)*iterations*1e9/double(total_ns);
+	}
+};
+
+
+inline std::ostream& operator << (std::ostream& outs, const Result& r) {
+	outs << "{\"benchmark\":\"" << r.name << "\""
+	     << ",\"scale\":"        << r.scale
+	     << ",\"iterations\":"   << r.iterations
+	     << ",\"ops\":"          << r.ops
+	     << ",\"ops_per_sec\":"  << std::fixed << r.ops_per_sec() << std::defaultfloat
+	     << ",\"sample\":\""     << r.sample << "\""
+	     << ",\"samples\":"      << r.ns.size()
+	     << ",\"p50_ns\":"       << r.percentile(50)
+	     << ",\"p90_ns\":"       << r.percentile(90)
+	     << ",\"p99_ns\":"       << r.percentile(99)
+	     << ",\"min_ns\":"       << (r.ns.empty() ? 0 : r.ns.front())
+	     << ",\"max_ns\":"       << (r.ns.empty() ? 0 : r.ns.back())
+	     << "}";
+	return outs;
+}
+
+
+inline std::int64_t nanoseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point stop) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(stop-start).count();
+}
+
+
+inline Result start_result(const Config& config, const std::string& name, long ops, const char* sample) {
+	Result r;
+	r.name       = name;
+	r.scale      = config.scale;
+	r.iterations = config.iterations;
+	r.ops        = ops;
+	r.sample     = sample;
+	return r;
+}
+
+
+inline void finish_result(Result& r) {
+	std::sort(r.ns.begin(), r.ns.end());
+	for (std::int64_t t : r.ns)
+		r.total_ns += t;
+	std::cout << r << std::endl;
+}
+
+
+//Time op(0), op(1), ... op(ops-1) one at a time, config.iterations times
+//  (after config.warmup untimed passes), and print the Result, whose
+//  percentiles are per operation, as a JSON line.
+//Benchmarks whose name does not contain config.filter are skipped.
+template<class Op>
+void run_each(const Config& config, const std::string& name, long ops, Op op) {
+	if (name.find(config.filter) == std::string::npos)
+		return;
+
+	for (int i = 0; i < config.warmup; ++i)
+		for (long o = 0; o < ops; ++o)
+			op(o);
+
+	Result r = start_result(config, name, ops, "op");
+	r.ns.reserve(std::size_t(config.iterations)*ops);
+	for (int i = 0; i < config.iterations; ++i)
+		for (long o = 0; o < ops; ++o) {
+			auto start = std::chrono::steady_clock::now();
+			op(o);
+			auto stop  = std::chrono::steady_clock::now();
+			r.ns.push_back(nanoseconds(start, stop));
+		}
+	finish_result(r);
+}
+
+
+//Time fn (a single call that performs ops operations, e.g. reading a file of
+//  ops lines) config.iterations times, after config.warmup untimed calls, and
+//  print the Result, whose percentiles are per call, as a JSON line.
+//Benchmarks whose name does not contain config.filter are skipped.
+template<class Fn>
+void run(const Config& config, const std::string& name, long ops, Fn fn) {
+	if (name.find(config.filter) == std::string::npos)
+		return;
+
+	for (int i = 0; i < config.warmup; ++i)
+		fn();
+
+	Result r = start_result(config, name, ops, "call");
+	r.ns.reserve(config.iterations);
+	for (int i = 0; i < config.iterations; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		auto stop  = std::chrono::steady_clock::now();
+		r.ns.push_back(nanoseconds(start, stop));
+	}
+	finish_result(r);
+}
+
+
+//Keep the optimizer from discarding a result that is otherwise unused.
+template<class T>
+void keep(const T& value) {
+	asm volatile("" : : "r"(&value) : "memory");
+}
+
+
+//Read a file of simulation descriptions (start state followed by inputs, all
+//  separated by semicolons) into (start state, Queue of inputs) pairs, the way
+//  the fa and ndfa main()s do, so that process() can be timed on its own.
+template<class Queue>
+std::vector<std::pair<std::string,Queue>> read_simulations(const std::string& file_name) {
+	std::vector<std::pair<std::string,Queue>> answer;
+	std::ifstream file(file_name.c_str());
+	std::string line;
+	std::vector<StrRef> words;
+	while (getline(file,line)) {
+		split_into(line,';',words);
+		Queue inputs;
+		for (std::size_t i = 1; i < words.size(); ++i)
+			inputs.enqueue(words[i].str());
+		answer.push_back(std::make_pair(words[0].str(), inputs));
+	}
+	return answer;
+}
+
+
+//One entry point per program (defined in bench_<program>.cpp).
+void bench_fa           (const Config& config);
+void bench_ndfa         (const Config& config);
+void bench_reachable    (const Config& config);
+void bench_runoffvoting (const Config& config);
+void bench_wordgenerator(const Config& config);
+
+}
+}
+
+#endif /* BENCH_HPP_ */
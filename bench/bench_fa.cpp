@@ -0,0 +1,82 @@
+#define DS_NO_MAIN
+#include "../src/fa.cpp"
+#include "multi_fa.hpp"
+#include "bench.hpp"
+#include "generators.hpp"
+
+
+namespace ds {
+namespace bench {
+
+void bench_fa(const Config& config) {
+	const int states = config.states*config.scale;
+	const int inputs = config.inputs;
+	const int lines  = config.lines*config.scale;
+	const int length = config.length;
+
+	const std::string fa_file     = config.dir + "/bench_fa.txt";
+	const std::string inputs_file = config.dir + "/bench_fainput.txt";
+	write_dfa      (fa_file,     states, inputs,                config.seed);
+	write_fa_inputs(inputs_file, states, inputs, lines, length, config.seed+1);
+
+	run(config, "fa/read_fa", states, [&] () {
+		std::ifstream file(fa_file.c_str());
+		FA fa = read_fa(file);
+		keep(fa);
+	});
+
+	run(config, "fa/read_inputs", lines, [&] () {
+		auto simulations = read_simulations<InputsQueue>(inputs_file);
+		keep(simulations);
+	});
+
+	std::ifstream file(fa_file.c_str());
+	const FA fa = read_fa(file);
+	const auto simulations = read_simulations<InputsQueue>(inputs_file);
+
+	//One operation: one process() call (one simulation description)
+	run_each(config, "fa/process", long(simulations.size()), [&] (long i) {
+		TransitionQueue t = process(fa, simulations[i].first, simulations[i].second);
+		keep(t);
+	});
+
+	//Several automata over the same descriptions: once each (as running fa once
+	//  per automaton does), then all together in one pass with a MultiFA.
+	//One operation: one description, run by every automaton
+	std::vector<FA> fas;
+	ds::MultiFA multi;
+	for (int i = 0; i < config.automata; ++i) {
+		const std::string file_name = config.dir + "/bench_fa" + std::to_string(i) + ".txt";
+		write_dfa(file_name, states, inputs, config.seed+10+i);
+		std::ifstream for_fa(file_name.c_str()), for_multi(file_name.c_str());
+		fas.push_back(read_fa(for_fa));
+		multi.add(file_name, for_multi);
+	}
+	std::vector<std::string> descriptions;
+	{
+		std::ifstream file(inputs_file.c_str());
+		for (std::string line; getline(file,line); )
+			descriptions.push_back(line);
+	}
+
+	std::vector<StrRef> words;
+	InputsQueue queue;
+	run_each(config, "fa/multi_separate", long(descriptions.size()), [&] (long i) {
+		for (const FA& f : fas) {
+			split_into(descriptions[i], ';', words);
+			queue.clear();
+			for (std::size_t w = 1; w < words.size(); ++w)
+				queue.enqueue(words[w].str());
+			TransitionQueue t = process(f, words[0].str(), queue);
+			keep(t);
+		}
+	});
+
+	run_each(config, "fa/multi_single_pass", long(descriptions.size()), [&] (long i) {
+		multi.run(descriptions[i]);
+		keep(multi);
+	});
+}
+
+}
+}
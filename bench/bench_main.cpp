@@ -0,0 +1,105 @@
+#include <string>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include "ics46goody.hpp"
+#include "bench.hpp"
+#include "profile.hpp"
+
+
+namespace {
+
+const char* const usage =
+	"usage: bench [--scale n] [--iterations n] [--warmup n] [--seed n] [--dir path] [--filter text]\n"
+	"             [--states n] [--inputs n] [--fanout n] [--lines n] [--length n] [--automata n]\n"
+	"             [--nodes n] [--edges n] [--starts n] [--voters n] [--candidates n]\n"
+	"             [--words n] [--vocabulary n] [--os n]\n"
+	"       (--states, --lines, --nodes, --edges, --voters and --words are multiplied by --scale)";
+
+//The workload size options and the Config fields they set
+struct Size {
+	const char* option;
+	int ds::bench::Config::*field;
+};
+
+const Size sizes[] = {
+	{"--states",     &ds::bench::Config::states},
+	{"--inputs",     &ds::bench::Config::inputs},
+	{"--fanout",     &ds::bench::Config::fanout},
+	{"--lines",      &ds::bench::Config::lines},
+	{"--length",     &ds::bench::Config::length},
+	{"--automata",   &ds::bench::Config::automata},
+	{"--nodes",      &ds::bench::Config::nodes},
+	{"--edges",      &ds::bench::Config::edges},
+	{"--starts",     &ds::bench::Config::starts},
+	{"--voters",     &ds::bench::Config::voters},
+	{"--candidates", &ds::bench::Config::candidates},
+	{"--words",      &ds::bench::Config::words},
+	{"--vocabulary", &ds::bench::Config::vocabulary},
+	{"--os",         &ds::bench::Config::os},
+};
+
+}
+
+
+//Generate synthetic inputs of the requested sizes and time each program's
+//  functions on them, printing one JSON line per benchmark on std::cout.
+int main(int argc, char* argv[]) {
+	DS_PROFILE_PROGRAM("bench");
+	ds::bench::Config config;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string option = argv[i];
+		if (option == "--help") {
+			std::cout << usage << std::endl;
+			return 0;
+		}
+		if (i+1 == argc) {
+			std::cerr << "bench: missing value for " << option << std::endl << usage << std::endl;
+			return 1;
+		}
+		const char* value = argv[++i];
+		const Size* size = nullptr;
+		for (const Size& s : sizes)
+			if (option == s.option)
+				size = &s;
+
+		if      (size != nullptr)          config.*size->field = std::atoi(value);
+		else if (option == "--scale")      config.scale      = std::atoi(value);
+		else if (option == "--iterations") config.iterations = std::atoi(value);
+		else if (option == "--warmup")     config.warmup     = std::atoi(value);
+		else if (option == "--seed")       config.seed       = std::strtoull(value, nullptr, 10);
+		else if (option == "--dir")        config.dir        = value;
+		else if (option == "--filter")     config.filter     = value;
+		else {
+			std::cerr << "bench: unknown option " << option << std::endl << usage << std::endl;
+			return 1;
+		}
+	}
+	if (config.scale < 1 || config.iterations < 1) {
+		std::cerr << "bench: --scale and --iterations must be positive" << std::endl;
+		return 1;
+	}
+	if (config.warmup < 0) {
+		std::cerr << "bench: --warmup must be non-negative" << std::endl;
+		return 1;
+	}
+	for (const Size& s : sizes)
+		if (config.*s.field < 1) {
+			std::cerr << "bench: " << s.option << " must be positive" << std::endl;
+			return 1;
+		}
+
+	try {
+		ds::bench::bench_fa(config);
+		ds::bench::bench_ndfa(config);
+		ds::bench::bench_reachable(config);
+		ds::bench::bench_runoffvoting(config);
+		ds::bench::bench_wordgenerator(config);
+	} catch (ics::IcsError& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
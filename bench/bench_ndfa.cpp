@@ -0,0 +1,44 @@
+#define DS_NO_MAIN
+#include "../src/ndfa.cpp"
+#include "bench.hpp"
+#include "generators.hpp"
+
+
+namespace ds {
+namespace bench {
+
+void bench_ndfa(const Config& config) {
+	const int states = config.states*config.scale;
+	const int inputs = config.inputs;
+	const int lines  = config.lines*config.scale;
+	const int length = config.length;
+
+	const std::string ndfa_file   = config.dir + "/bench_ndfa.txt";
+	const std::string inputs_file = config.dir + "/bench_ndfainput.txt";
+	write_ndfa     (ndfa_file,   states, inputs, config.fanout, config.seed);
+	write_fa_inputs(inputs_file, states, inputs, lines, length, config.seed+1);
+
+	run(config, "ndfa/read_ndfa", states, [&] () {
+		std::ifstream file(ndfa_file.c_str());
+		NDFA ndfa = read_ndfa(file);
+		keep(ndfa);
+	});
+
+	run(config, "ndfa/read_inputs", lines, [&] () {
+		auto simulations = read_simulations<InputsQueue>(inputs_file);
+		keep(simulations);
+	});
+
+	std::ifstream file(ndfa_file.c_str());
+	const NDFA ndfa = read_ndfa(file);
+	const auto simulations = read_simulations<InputsQueue>(inputs_file);
+
+	//One operation: one process() call (one simulation description)
+	run_each(config, "ndfa/process", long(simulations.size()), [&] (long i) {
+		TransitionsQueue t = process(ndfa, simulations[i].first, simulations[i].second);
+		keep(t);
+	});
+}
+
+}
+}
@@ -0,0 +1,40 @@
+#define DS_NO_MAIN
+#include "../src/reachable.cpp"
+#include "bench.hpp"
+#include "generators.hpp"
+
+
+namespace ds {
+namespace bench {
+
+void bench_reachable(const Config& config) {
+	const int nodes  = config.nodes*config.scale;
+	const int edges  = config.edges*config.scale;
+
+	const std::string graph_file = config.dir + "/bench_graph.txt";
+	write_edges(graph_file, nodes, edges, 1.1, config.seed);
+
+	run(config, "reachable/read_graph", edges, [&] () {
+		std::ifstream file(graph_file.c_str());
+		Graph g = read_graph(file);
+		keep(g);
+	});
+
+	std::ifstream file(graph_file.c_str());
+	const Graph g = read_graph(file);
+
+	//Power-law sources: the lowest numbered nodes have the most edges
+	std::vector<std::string> start_nodes;
+	for (int i = 0; i < nodes && int(start_nodes.size()) < config.starts; ++i)
+		if (g.has_key(name("n",i)))
+			start_nodes.push_back(name("n",i));
+
+	//One operation: one reachable() call (one start node)
+	run_each(config, "reachable/reachable", long(start_nodes.size()), [&] (long i) {
+		NodeSet answer = reachable(g, start_nodes[i]);
+		keep(answer);
+	});
+}
+
+}
+}
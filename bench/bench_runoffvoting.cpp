@@ -0,0 +1,49 @@
+#define DS_NO_MAIN
+#include "../src/runoffvoting.cpp"
+#include "bench.hpp"
+#include "generators.hpp"
+
+
+namespace ds {
+namespace bench {
+
+void bench_runoffvoting(const Config& config) {
+	const int voters     = config.voters*config.scale;
+	const int candidates = config.candidates;
+
+	const std::string ballot_file = config.dir + "/bench_votepref.txt";
+	write_ballots(ballot_file, voters, candidates, config.seed);
+
+	run(config, "runoffvoting/read_voter_preferences", voters, [&] () {
+		std::ifstream file(ballot_file.c_str());
+		Preferences p = read_voter_preferences(file);
+		keep(p);
+	});
+
+	std::ifstream file(ballot_file.c_str());
+	const Preferences p = read_voter_preferences(file);
+	CandidateSet all;
+	for (int c = 0; c < candidates; ++c)
+		all.insert(name("c",c));
+
+	//The candidates still in the election on each ballot of the runoff, as
+	//  runoffvoting's main() computes them
+	std::vector<CandidateSet> ballots;
+	for (CandidateSet still_in = all; still_in.size() >= 2; still_in = remaining_candidates(evaluate_ballot(p, still_in)))
+		ballots.push_back(still_in);
+
+	//One operation: one evaluate_ballot() call (one ballot of the runoff)
+	run_each(config, "runoffvoting/evaluate_ballot", long(ballots.size()), [&] (long i) {
+		CandidateTally tally = evaluate_ballot(p, ballots[i]);
+		keep(tally);
+	});
+
+	const CandidateTally tally = evaluate_ballot(p, all);
+	run_each(config, "runoffvoting/remaining_candidates", 1, [&] (long) {
+		CandidateSet remaining = remaining_candidates(tally);
+		keep(remaining);
+	});
+}
+
+}
+}
@@ -0,0 +1,26 @@
+#define DS_NO_MAIN
+#include "../src/wordgenerator.cpp"
+#include "bench.hpp"
+#include "generators.hpp"
+
+
+namespace ds {
+namespace bench {
+
+void bench_wordgenerator(const Config& config) {
+	const int words      = config.words*config.scale;
+	const int vocabulary = config.vocabulary;
+	const int os         = config.os;
+
+	const std::string corpus_file = config.dir + "/bench_wginput.txt";
+	write_corpus(corpus_file, words, vocabulary, 12, config.seed);
+
+	run(config, "wordgenerator/read_corpus", words, [&] () {
+		std::ifstream file(corpus_file.c_str());
+		Corpus corpus = read_corpus(os, file);
+		keep(corpus);
+	});
+}
+
+}
+}
@@ -0,0 +1,163 @@
+#ifndef GENERATORS_HPP_
+#define GENERATORS_HPP_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include "ics46goody.hpp"
+
+
+//Synthetic workload generators: each writes a file in the same format as the
+//  sample inputs in the project directory (faparity.txt, graph1.txt, ...).
+//Only std::mt19937_64's raw output is used (its sequence is fixed by the
+//  standard; the std distributions are not), so the same seed produces the same
+//  file with every compiler and library.
+namespace ds {
+namespace bench {
+
+
+class Random {
+  public:
+	explicit Random(std::uint64_t seed) : engine(seed) {}
+
+	//Uniform in [0,n)
+	int below(int n) {return int(engine() % std::uint64_t(n));}
+
+	//Uniform in [0,1)
+	double unit() {return (engine() >> 11) * (1.0/9007199254740992.0);}
+
+  private:
+	std::mt19937_64 engine;
+};
+
+
+//Zipf (power-law) distribution over [0,n): value k is chosen with probability
+//  proportional to 1/(k+1)^exponent.
+class Zipf {
+  public:
+	Zipf(int n, double exponent) : cumulative(n) {
+		double total = 0.0;
+		for (int k = 0; k < n; ++k)
+			cumulative[k] = total += 1.0/std::pow(k+1.0, exponent);
+		for (double& c : cumulative)
+			c /= total;
+	}
+
+	int operator () (Random& random) const {
+		auto i = std::upper_bound(cumulative.begin(), cumulative.end(), random.unit());
+		return i == cumulative.end() ? int(cumulative.size())-1 : int(i-cumulative.begin());
+	}
+
+  private:
+	std::vector<double> cumulative;
+};
+
+
+inline std::string name(const char* prefix, int i) {return prefix + std::to_string(i);}
+
+
+inline void open_for_writing(std::ofstream& file, const std::string& file_name) {
+	file.open(file_name.c_str());
+	if (!file)
+		throw ics::IcsError("generators: cannot write " + file_name);
+}
+
+
+//A complete DFA: states s0..s<states-1>, each with one transition on every
+//  input i0..i<inputs-1> to a random state.
+inline void write_dfa(const std::string& file_name, int states, int inputs, std::uint64_t seed) {
+	Random random(seed);
+	std::ofstream file;
+	open_for_writing(file, file_name);
+	for (int s = 0; s < states; ++s) {
+		file << name("s",s);
+		for (int i = 0; i < inputs; ++i)
+			file << ';' << name("i",i) << ';' << name("s",random.below(states));
+		file << '\n';
+	}
+}
+
+
+//An NDFA over the same names: each state has 1..fanout transitions on every
+//  input (possibly repeating a target, as the sample files do).
+inline void write_ndfa(const std::string& file_name, int states, int inputs, int fanout, std::uint64_t seed) {
+	Random random(seed);
+	std::ofstream file;
+	open_for_writing(file, file_name);
+	for (int s = 0; s < states; ++s) {
+		file << name("s",s);
+		for (int i = 0; i < inputs; ++i)
+			for (int f = 1 + random.below(fanout); f > 0; --f)
+				file << ';' << name("i",i) << ';' << name("s",random.below(states));
+		file << '\n';
+	}
+}
+
+
+//Simulation descriptions for write_dfa/write_ndfa automata: each line is a start
+//  state followed by length inputs.
+inline void write_fa_inputs(const std::string& file_name, int states, int inputs, int lines, int length, std::uint64_t seed) {
+	Random random(seed);
+	std::ofstream file;
+	open_for_writing(file, file_name);
+	for (int l = 0; l < lines; ++l) {
+		file << name("s",random.below(states));
+		for (int i = 0; i < length; ++i)
+			file << ';' << name("i",random.below(inputs));
+		file << '\n';
+	}
+}
+
+
+//An edge list whose source (and destination) nodes follow a power law, so a few
+//  nodes have most of the edges, as in real graphs.
+inline void write_edges(const std::string& file_name, int nodes, int edges, double exponent, std::uint64_t seed) {
+	Random random(seed);
+	Zipf   zipf(nodes, exponent);
+	std::ofstream file;
+	open_for_writing(file, file_name);
+	for (int e = 0; e < edges; ++e)
+		file << name("n",zipf(random)) << ';' << name("n",zipf(random)) << '\n';
+}
+
+
+//Ballots: every voter ranks all the candidates in a random order.
+inline void write_ballots(const std::string& file_name, int voters, int candidates, std::uint64_t seed) {
+	Random random(seed);
+	std::vector<int> order(candidates);
+	std::ofstream file;
+	open_for_writing(file, file_name);
+	for (int v = 0; v < voters; ++v) {
+		for (int c = 0; c < candidates; ++c)
+			order[c] = c;
+		for (int c = candidates-1; c > 0; --c)
+			std::swap(order[c], order[random.below(c+1)]);
+		file << name("v",v);
+		for (int c : order)
+			file << ';' << name("c",c);
+		file << '\n';
+	}
+}
+
+
+//Text: words drawn from a vocabulary with Zipf-distributed frequencies (like
+//  natural language), words_per_line words on each line, separated by spaces.
+inline void write_corpus(const std::string& file_name, int words, int vocabulary, int words_per_line, std::uint64_t seed) {
+	Random random(seed);
+	Zipf   zipf(vocabulary, 1.0);
+	std::ofstream file;
+	open_for_writing(file, file_name);
+	for (int w = 0; w < words; ++w) {
+		file << name("w",zipf(random));
+		file << ((w+1) % words_per_line == 0 || w+1 == words ? '\n' : ' ');
+	}
+}
+
+}
+}
+
+#endif /* GENERATORS_HPP_ */
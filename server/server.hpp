@@ -0,0 +1,112 @@
+#ifndef SERVER_HPP_
+#define SERVER_HPP_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "ics46goody.hpp"
+#include "string_pool.hpp"
+
+
+//Query server: a data set (FA, NDFA, graph, ballots or corpus) is read once at
+//  startup and then answers requests from any number of clients over a Unix
+//  domain socket.
+//Each request is one line: a verb followed by its arguments, all separated by
+//  semicolons (like the lines in the input files); each gets exactly one
+//  response line, in request order: "ok" or "error" followed by the results,
+//  again separated by semicolons.
+//
+//  simulate;start;input;input...  ok;stop state ("None" if an input is illegal;
+//                                 for an NDFA, the states in the last Set)
+//  reachable;node                 ok;node;node...   (every node reachable)
+//  tally[;candidate...]           ok;candidate;votes;candidate;votes...
+//                                 (first ballot, with all or the given candidates)
+//  generate;count;word...         ok;word;word...   (start words + count more)
+//
+//Clients may send many requests without waiting (pipelining): every complete
+//  line in what has arrived is answered, and all those responses are sent back
+//  together.
+namespace ds {
+namespace server {
+
+
+//Answers the requests for one verb from a data set loaded at startup; answer
+//  is called concurrently from the client threads, so it must not change the
+//  data set.
+class Service {
+  public:
+	virtual ~Service() {}
+	virtual const char* verb() const = 0;
+
+	//request[0] is the verb; append the response (without its '\n') to response.
+	virtual void answer(const std::vector<StrRef>& request, std::string& response) const = 0;
+};
+
+typedef std::vector<std::unique_ptr<Service>> Services;
+
+
+inline void append_ok(std::string& response) {
+	response += "ok";
+}
+
+inline void append_error(std::string& response, const std::string& message) {
+	response += "error;";
+	response += message;
+}
+
+//Append ";value" for each value in an ics container (or anything iterable).
+template<class Iterable>
+void append_all(std::string& response, const Iterable& values) {
+	for (const auto& v : values) {
+		response += ';';
+		response += v;
+	}
+}
+
+
+//The Service for each kind of data set (defined in server_<program>.cpp); each
+//  throws ics::IcsError if its file cannot be read.
+std::unique_ptr<Service> load_fa     (const std::string& file_name);
+std::unique_ptr<Service> load_ndfa   (const std::string& file_name);
+std::unique_ptr<Service> load_graph  (const std::string& file_name);
+std::unique_ptr<Service> load_ballots(const std::string& file_name);
+std::unique_ptr<Service> load_corpus (const std::string& file_name, int os);
+
+
+//Answer every complete line at the front of requests (removing them), appending
+//  one response line for each to responses; an incomplete last line is left in
+//  requests until the rest of it arrives.
+//words is scratch space, reused from call to call.
+inline void answer_all(const Services& services, std::string& requests, std::string& responses, std::vector<StrRef>& words) {
+	std::string::size_type start = 0;
+	for (std::string::size_type end; (end = requests.find('\n', start)) != std::string::npos; start = end+1) {
+		std::string::size_type length = end-start;
+		if (length > 0 && requests[end-1] == '\r')
+			--length;
+		split_into(StrRef(requests.data()+start, length), ';', words);
+
+		const Service* service = nullptr;
+		for (const auto& s : services)
+			if (words[0] == s->verb())
+				service = s.get();
+
+		if (service == nullptr)
+			append_error(responses, "unknown request " + words[0].str());
+		else {
+			std::string::size_type answered = responses.size();
+			try {
+				service->answer(words, responses);
+			} catch (ics::IcsError& e) {
+				responses.resize(answered);
+				append_error(responses, e.what());
+			}
+		}
+		responses += '\n';
+	}
+	requests.erase(0, start);
+}
+
+}
+}
+
+#endif /* SERVER_HPP_ */
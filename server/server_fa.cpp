@@ -0,0 +1,55 @@
+#define DS_NO_MAIN
+#include "../src/fa.cpp"
+#include "server.hpp"
+
+
+namespace ds {
+namespace server {
+
+namespace {
+
+class FAService : public Service {
+  public:
+	explicit FAService(const FA& fa) : fa(fa) {}
+
+	const char* verb() const {return "simulate";}
+
+	void answer(const std::vector<StrRef>& request, std::string& response) const {
+		if (request.size() < 2) {
+			append_error(response, "simulate needs a start state");
+			return;
+		}
+		if (!fa.has_key(request[1].str())) {
+			append_error(response, request[1].str() + " is not a state in the finite automaton");
+			return;
+		}
+		InputsQueue inputs;
+		for (std::size_t i = 2; i < request.size(); ++i)
+			inputs.enqueue(request[i].str());
+		TransitionQueue tq = process(fa, request[1].str(), inputs);
+
+		//The last transition holds the stop state ("None" after an illegal input)
+		std::string stop;
+		for (const auto& t : tq)
+			stop = t.second;
+		append_ok(response);
+		response += ';';
+		response += stop;
+	}
+
+  private:
+	const FA fa;
+};
+
+}
+
+
+std::unique_ptr<Service> load_fa(const std::string& file_name) {
+	std::ifstream file(file_name.c_str());
+	if (!file)
+		throw ics::IcsError("cannot open finite automaton file " + file_name);
+	return std::unique_ptr<Service>(new FAService(read_fa(file)));
+}
+
+}
+}
@@ -0,0 +1,166 @@
+#include <string>
+#include <iostream>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "ics46goody.hpp"
+#include "server.hpp"
+#include "profile.hpp"
+
+
+namespace {
+
+const char* const usage =
+	"usage: server [--socket path] [--fa file | --ndfa file] [--graph file] [--ballots file] [--corpus file] [--os n]\n"
+	"       (--os is the corpus's order statistic, 2 by default, wherever it appears)";
+
+
+//Set by SIGINT or SIGTERM: the server reports its profile (in a -DDS_PROFILE
+//  build) and stops.
+volatile std::sig_atomic_t stopping = 0;
+
+void stop(int) {stopping = 1;}
+
+
+//Send all of data, however many send calls it takes; false if the client is gone.
+bool send_all(int client, const std::string& data) {
+	for (std::string::size_type sent = 0; sent < data.size(); ) {
+		ssize_t n = send(client, data.data()+sent, data.size()-sent, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		sent += n;
+	}
+	return true;
+}
+
+
+//Serve one client until it disconnects: answer every complete request in each
+//  read, sending all of their responses with one send.
+void serve(int client, const ds::server::Services& services) {
+	std::string requests, responses;
+	std::vector<ds::StrRef> words;
+	char buffer[64*1024];
+
+	for (;;) {
+		ssize_t n = read(client, buffer, sizeof(buffer));
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+		requests.append(buffer, n);
+		ds::server::answer_all(services, requests, responses, words);
+		if (!responses.empty()) {
+			if (!send_all(client, responses))
+				break;
+			responses.clear();
+		}
+	}
+	close(client);
+}
+
+}
+
+
+//Read the data sets named on the command line, then accept clients on a Unix
+//  domain socket, serving each one on its own thread (the data sets are only
+//  read after startup, so the threads share them without locking).
+int main(int argc, char* argv[]) {
+	DS_PROFILE_PROGRAM("server");
+	std::string socket_path = "/tmp/ds.sock";
+	int os = 2;
+	std::vector<std::string> corpus_files;   //read once os is known
+	ds::server::Services services;
+
+	try {
+		for (int i = 1; i < argc; ++i) {
+			std::string option = argv[i];
+			if (i+1 == argc) {
+				std::cerr << "server: missing value for " << option << std::endl << usage << std::endl;
+				return 1;
+			}
+			const char* value = argv[++i];
+			if      (option == "--socket")  socket_path = value;
+			else if (option == "--os")      os = std::atoi(value);
+			else if (option == "--fa")      services.push_back(ds::server::load_fa(value));
+			else if (option == "--ndfa")    services.push_back(ds::server::load_ndfa(value));
+			else if (option == "--graph")   services.push_back(ds::server::load_graph(value));
+			else if (option == "--ballots") services.push_back(ds::server::load_ballots(value));
+			else if (option == "--corpus")  corpus_files.push_back(value);
+			else {
+				std::cerr << "server: unknown option " << option << std::endl << usage << std::endl;
+				return 1;
+			}
+		}
+		if (os < 1) {
+			std::cerr << "server: --os must be positive" << std::endl;
+			return 1;
+		}
+		for (const std::string& file_name : corpus_files)
+			services.push_back(ds::server::load_corpus(file_name, os));
+	} catch (ics::IcsError& e) {
+		std::cerr << "server: " << e.what() << std::endl;
+		return 1;
+	}
+
+	if (services.empty()) {
+		std::cerr << "server: no data set to serve" << std::endl << usage << std::endl;
+		return 1;
+	}
+	for (std::size_t i = 0; i < services.size(); ++i)
+		for (std::size_t j = i+1; j < services.size(); ++j)
+			if (std::strcmp(services[i]->verb(), services[j]->verb()) == 0) {
+				std::cerr << "server: more than one data set answers " << services[i]->verb() << std::endl;
+				return 1;
+			}
+
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socket_path.size() >= sizeof(address.sun_path)) {
+		std::cerr << "server: socket path too long: " << socket_path << std::endl;
+		return 1;
+	}
+	std::strcpy(address.sun_path, socket_path.c_str());
+
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(socket_path.c_str());
+	if (listener < 0
+	    || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+	    || listen(listener, SOMAXCONN) < 0) {
+		std::cerr << "server: cannot listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+		return 1;
+	}
+	std::cerr << "server: listening on " << socket_path << std::endl;
+
+	//Without SA_RESTART, a signal interrupts accept so the loop sees stopping
+	struct sigaction action;
+	std::memset(&action, 0, sizeof(action));
+	action.sa_handler = stop;
+	sigaction(SIGINT,  &action, nullptr);
+	sigaction(SIGTERM, &action, nullptr);
+
+	for (;;) {
+		int client = accept(listener, nullptr, nullptr);
+		if (stopping) {
+			//Client threads may still be running, so skip the static destructors
+			std::cerr << "server: stopping" << std::endl;
+			unlink(socket_path.c_str());
+			DS_PROFILE_REPORT();
+			_exit(0);
+		}
+		if (client < 0) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			std::cerr << "server: accept failed: " << std::strerror(errno) << std::endl;
+			return 1;
+		}
+		std::thread(serve, client, std::cref(services)).detach();
+	}
+}
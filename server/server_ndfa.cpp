@@ -0,0 +1,54 @@
+#define DS_NO_MAIN
+#include "../src/ndfa.cpp"
+#include "server.hpp"
+
+
+namespace ds {
+namespace server {
+
+namespace {
+
+class NDFAService : public Service {
+  public:
+	explicit NDFAService(const NDFA& ndfa) : ndfa(ndfa) {}
+
+	const char* verb() const {return "simulate";}
+
+	void answer(const std::vector<StrRef>& request, std::string& response) const {
+		if (request.size() < 2) {
+			append_error(response, "simulate needs a start state");
+			return;
+		}
+		if (!ndfa.has_key(request[1].str())) {
+			append_error(response, request[1].str() + " is not a state in the non-deterministic finite automaton");
+			return;
+		}
+		InputsQueue inputs;
+		for (std::size_t i = 2; i < request.size(); ++i)
+			inputs.enqueue(request[i].str());
+		TransitionsQueue tq = process(ndfa, request[1].str(), inputs);
+
+		//The last transition holds the Set of stop states
+		const States* stop = nullptr;
+		for (const auto& t : tq)
+			stop = &t.second;
+		append_ok(response);
+		append_all(response, *stop);
+	}
+
+  private:
+	const NDFA ndfa;
+};
+
+}
+
+
+std::unique_ptr<Service> load_ndfa(const std::string& file_name) {
+	std::ifstream file(file_name.c_str());
+	if (!file)
+		throw ics::IcsError("cannot open non-deterministic finite automaton file " + file_name);
+	return std::unique_ptr<Service>(new NDFAService(read_ndfa(file)));
+}
+
+}
+}
@@ -0,0 +1,46 @@
+#define DS_NO_MAIN
+#include "../src/reachable.cpp"
+#include "server.hpp"
+
+
+namespace ds {
+namespace server {
+
+namespace {
+
+class GraphService : public Service {
+  public:
+	explicit GraphService(const Graph& graph) : graph(graph) {}
+
+	const char* verb() const {return "reachable";}
+
+	void answer(const std::vector<StrRef>& request, std::string& response) const {
+		if (request.size() != 2) {
+			append_error(response, "reachable needs exactly one node name");
+			return;
+		}
+		const std::string node = request[1].str();
+		if (!graph.has_key(node)) {
+			append_error(response, node + " is not a source node name in the graph");
+			return;
+		}
+		append_ok(response);
+		append_all(response, reachable(graph, node));
+	}
+
+  private:
+	const Graph graph;
+};
+
+}
+
+
+std::unique_ptr<Service> load_graph(const std::string& file_name) {
+	std::ifstream file(file_name.c_str());
+	if (!file)
+		throw ics::IcsError("cannot open graph file " + file_name);
+	return std::unique_ptr<Service>(new GraphService(read_graph(file)));
+}
+
+}
+}
@@ -0,0 +1,57 @@
+#define DS_NO_MAIN
+#include "../src/runoffvoting.cpp"
+#include "server.hpp"
+
+
+namespace ds {
+namespace server {
+
+namespace {
+
+class BallotService : public Service {
+  public:
+	explicit BallotService(const Preferences& preferences) : preferences(preferences) {
+		for (const auto& voter : preferences)
+			for (const auto& c : voter.second)
+				all.insert(c);
+	}
+
+	const char* verb() const {return "tally";}
+
+	void answer(const std::vector<StrRef>& request, std::string& response) const {
+		CandidateTally tally;
+		if (request.size() == 1)
+			tally = evaluate_ballot(preferences, all);
+		else {
+			CandidateSet candidates;
+			for (std::size_t i = 1; i < request.size(); ++i)
+				candidates.insert(request[i].str());
+			tally = evaluate_ballot(preferences, candidates);
+		}
+
+		append_ok(response);
+		for (const auto& t : tally) {
+			response += ';';
+			response += t.first;
+			response += ';';
+			response += std::to_string(t.second);
+		}
+	}
+
+  private:
+	const Preferences preferences;
+	CandidateSet      all;
+};
+
+}
+
+
+std::unique_ptr<Service> load_ballots(const std::string& file_name) {
+	std::ifstream file(file_name.c_str());
+	if (!file)
+		throw ics::IcsError("cannot open voter preference file " + file_name);
+	return std::unique_ptr<Service>(new BallotService(read_voter_preferences(file)));
+}
+
+}
+}
@@ -0,0 +1,57 @@
+#define DS_NO_MAIN
+#include <cstdlib>
+#include <cerrno>
+#include "../src/wordgenerator.cpp"
+#include "server.hpp"
+
+
+namespace ds {
+namespace server {
+
+namespace {
+
+class CorpusService : public Service {
+  public:
+	CorpusService(const Corpus& corpus, int os) : corpus(corpus), os(os) {}
+
+	const char* verb() const {return "generate";}
+
+	void answer(const std::vector<StrRef>& request, std::string& response) const {
+		if (int(request.size()) != 2+os) {
+			append_error(response, "generate needs a count and " + std::to_string(os) + " start words");
+			return;
+		}
+		//The whole count must be a number (atoi would read "x" as 0)
+		std::string digits = request[1].str();
+		char* end = nullptr;
+		errno = 0;
+		long count = std::strtol(digits.c_str(), &end, 10);
+		if (digits.empty() || *end != '\0' || errno == ERANGE || count < 0 || count > std::numeric_limits<int>::max()) {
+			append_error(response, "generate needs a non-negative count");
+			return;
+		}
+		WordQueue start;
+		for (std::size_t i = 2; i < request.size(); ++i)
+			start.enqueue(request[i].str());
+
+		append_ok(response);
+		append_all(response, produce_text(corpus, start, int(count)));
+	}
+
+  private:
+	const Corpus corpus;
+	const int    os;
+};
+
+}
+
+
+std::unique_ptr<Service> load_corpus(const std::string& file_name, int os) {
+	std::ifstream file(file_name.c_str());
+	if (!file)
+		throw ics::IcsError("cannot open corpus file " + file_name);
+	return std::unique_ptr<Service>(new CorpusService(read_corpus(os, file), os));
+}
+
+}
+}
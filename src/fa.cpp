@@ -8,6 +8,10 @@
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "string_pool.hpp"
+#include "profile.hpp"
+#include "output.hpp"
+#include "trace.hpp"
 
 
 typedef ics::ArrayQueue<std::string>                InputsQueue;
@@ -31,18 +35,20 @@ typedef ics::ArrayQueue<Transition>                 TransitionQueue;
 //  whose keys are states and whose associated values are another Map with
 //  each input in that state (keys) and the resulting state it leads to.
 const FA read_fa(std::ifstream &file) {
+	DS_PROFILE_PHASE(read);
 	FA answer;
 	std::string line;
+	std::vector<ds::StrRef> words; //words on each line after split of ';' (reused for every line)
 
 	while(getline(file, line)){
-		std::vector<std::string> words = ics::split(line, ";"); //words on each line after split of ';'
-		InputStateMap input;
-		for(int i = 1; i < words.size(); i += 2)
+		ds::split_into(line, ';', words);
+		InputStateMap& input = answer[words[0].str()];
+		DS_PROFILE_COUNT(inserts,1);
+		for(std::size_t i = 1; i+1 < words.size(); i += 2)
 		{
-			//std::cout << "Words: " << words.front() << std::endl;
-			input[words[i]] = words[i+1];
+			input[words[i].str()] = words[i+1].str();
+			DS_PROFILE_COUNT(inserts,1);
 		}
-		answer[words[0]] = input;
 	}
 
 	file.close();
@@ -55,14 +61,15 @@ const FA read_fa(std::ifstream &file) {
 //  alphabetical order of the states: each line has a state, the text
 //  "transitions:" and the Map of its transitions.
 void print_fa(const FA& fa) {
-	std::cout << std::endl << "Finite Automaton Description" << std::endl;
+	DS_PROFILE_PHASE(print);
+	ds::out() << "\nFinite Automaton Description\n";
 
-	for(auto i : fa)
+	for(const auto& i : fa)
 	{
-		std::cout << "   ";
-		std::cout << i.first << " transitions: " << i.second << std::endl;
+		ds::out() << "   ";
+		ds::out() << i.first << " transitions: " << i.second << '\n';
 	}
-	std::cout << std::endl;
+	ds::out() << '\n';
 }
 
 
@@ -73,23 +80,27 @@ void print_fa(const FA& fa) {
 //If any input i is illegal (does not lead to a state in the finite
 //  automaton), then the last pair in the returned queue is i,"None".
 TransitionQueue process(const FA& fa, std::string state, const InputsQueue& inputs) {
+	DS_PROFILE_PHASE(process);
 
 	TransitionQueue answer;
 
 	answer.enqueue(Transition("", state));
 
-	for (auto i : inputs)
+	for (const auto& i : inputs)
 	{
-		if((fa[state].has_key(i)))
+		const InputStateMap& transitions = fa[state];
+		DS_PROFILE_COUNT(lookups,2);
+		if((transitions.has_key(i)))
 		{
-			answer.enqueue(Transition(i, fa[state][i]));
+			state = transitions[i];
+			DS_PROFILE_COUNT(lookups,1);
+			answer.enqueue(Transition(i, state));
 		}
 		else
 		{
 			answer.enqueue(Transition(i, "None"));
 			break;
 		}
-		state = fa[state][i];
 	}
 	return answer;
 }
@@ -101,30 +112,39 @@ TransitionQueue process(const FA& fa, std::string state, const InputsQueue& inpu
 //  resulting new state (or "illegal input: terminated", if the state is
 //  "None") indented on subsequent lines; on the last line, print the Stop
 //  state (which may be "None").
-void interpret(TransitionQueue& tq) {  //or TransitionQueue or TransitionQueue&&
-
+//If trace is not nullptr, also record the simulation in it.
+void interpret(TransitionQueue& tq, ds::TraceWriter* trace = nullptr) {  //or TransitionQueue or TransitionQueue&&
+	DS_PROFILE_PHASE(print);
 	std::string lastState;
-	std::cout << "Start state = " << tq.peek().second << std::endl;
+	ds::out() << "Start state = " << tq.peek().second << '\n';
+	if (trace != nullptr)
+		trace->start(tq.peek().second);
 
-	for (auto i : tq)
+	for (const auto& i : tq)
 	{
 		if (i.first != "")
 		{
 			if (i.second == "None") //t.second checks state
 			{
-				std::cout << " Input = " << i.first << "; illegal input: terminated" << std::endl;
-				std::cout << "Stop state = None" << std::endl;
+				ds::out() << " Input = " << i.first << "; illegal input: terminated\n";
+				ds::out() << "Stop state = None\n";
+				if (trace != nullptr)
+					trace->illegal(i.first);
 				return;
 			}
 
 			else
 			{
-				std::cout << " Input = " << i.first << "; new state = " << i.second << std::endl;
+				ds::out() << " Input = " << i.first << "; new state = " << i.second << '\n';
 				lastState = i.second;
+				if (trace != nullptr)
+					trace->transition(i.first, i.second);
 			}
 		}
 	}
-	std::cout << "Stop state = " << lastState << std::endl;
+	ds::out() << "Stop state = " << lastState << '\n';
+	if (trace != nullptr)
+		trace->end();
 }
 
 
@@ -136,32 +156,44 @@ void interpret(TransitionQueue& tq) {  //or TransitionQueue or TransitionQueue&&
 //  semicolons.
 //Repeatedly read a description, print that description, put each input in a
 //  Queue, process the Queue and print the results in a nice form.
+#ifndef DS_NO_MAIN
 int main() {
+ DS_PROFILE_PROGRAM("fa");
  try {
 
 	    std::ifstream text_file;
 	    ics::safe_open(text_file,"Enter the file name with a Finite Automaton","faparity.txt");
 	    FA f = read_fa(text_file);
 	    print_fa(f);
+	    ds::out().flush();
 
 	    std::ifstream text_file_inputs;
 	    ics::safe_open(text_file_inputs,"\nEnter the name of the file with the start-state and input","fainputparity.txt");
 
 	    std::string line;
+	    std::vector<ds::StrRef> state_inputs;
+	    InputsQueue inputs;
+	    std::unique_ptr<ds::TraceWriter> trace = ds::open_trace(ds::TraceWriter::kind_fa);
 
 	    while (getline(text_file_inputs,line)) {
-	      std::cout << "\nStarting new simulation with description: " << line << std::endl;
-	      std::vector<std::string> state_inputs = ics::split(line,";");
-	      InputsQueue inputs;
-	      for (int i = 1; i < state_inputs.size(); i++)
-	    	  inputs.enqueue(state_inputs[i]);
-	      TransitionQueue t = process(f,state_inputs[0],inputs);
-	      interpret(t);
+	      ds::out() << "\nStarting new simulation with description: " << line << '\n';
+	      if (trace)
+	    	  trace->description(line);
+	      {
+	    	  DS_PROFILE_PHASE(build);
+	    	  ds::split_into(line,';',state_inputs);
+	    	  inputs.clear();
+	    	  for (std::size_t i = 1; i < state_inputs.size(); i++)
+	    		  inputs.enqueue(state_inputs[i].str());
+	      }
+	      TransitionQueue t = process(f,state_inputs[0].str(),inputs);
+	      interpret(t,trace.get());
 	    }
 
  } catch (ics::IcsError& e) {
-   std::cout << e.what() << std::endl;
+   ds::out() << e.what() << '\n';
  }
 
  return 0;
 }
+#endif
@@ -0,0 +1,256 @@
+#ifndef MULTI_FA_HPP_
+#define MULTI_FA_HPP_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include "ics46goody.hpp"
+#include "string_pool.hpp"
+
+
+//Runs several finite automata over the same simulation descriptions in one
+//  pass: each description is split once, each input is looked up once in an
+//  alphabet shared by all the automata, and all the automata then advance
+//  together.
+//Each automaton is compiled to a dense table over its own inputs (state id x
+//  local input id -> state id), plus a map from the shared alphabet's ids to
+//  its local ids, so it takes memory in proportion to its own states and
+//  inputs (and the size of the shared alphabet), never states x shared
+//  alphabet; these tables are not capped, since they are linear in the size
+//  of the files read.
+//Tuples of their states are the states of the product automaton, which is
+//  built lazily: a product transition is computed (by stepping every automaton)
+//  the first time it is needed and then reused. Each product state costs one
+//  int per input in the shared alphabet (its transitions) plus one per
+//  automaton (its tuple), so this cache is capped in bytes: when adding a state
+//  would take its tables past max_cache_bytes, the cache is dropped and rebuilt
+//  from the current state, so memory stays bounded even when the full product
+//  (or the alphabet) is large. The vectors holding the cache may reserve up to
+//  twice what they use.
+namespace ds {
+
+
+class MultiFA {
+  public:
+	enum {none = -1};   //the state after an illegal input ("None")
+
+	explicit MultiFA(std::size_t max_cache_bytes = 64 << 20) : max_cache_bytes(max_cache_bytes), stride(0) {}
+	MultiFA(const MultiFA&) = delete;
+	MultiFA& operator = (const MultiFA&) = delete;
+
+	//Read an open file describing a finite automaton (in the format read_fa
+	//  reads) and add it under the given name; its initial state is the first
+	//  state in the file.
+	void add(const std::string& name, std::ifstream& file) {
+		std::unique_ptr<Automaton> fa(new Automaton);
+		fa->name = name;
+		std::string line;
+		std::vector<StrRef> words;
+		while (getline(file, line)) {
+			split_into(line, ';', words);
+			int state = fa->states.intern(words[0]);
+			for (std::size_t i = 1; i+1 < words.size(); i += 2) {
+				fa->edges.push_back(state);
+				fa->edges.push_back(fa->local_input(inputs.intern(words[i])));
+				fa->edges.push_back(fa->states.intern(words[i+1]));
+			}
+		}
+		file.close();
+		if (fa->states.size() == 0)
+			throw ics::IcsError("MultiFA.add: no states in finite automaton " + name);
+		automata.push_back(std::move(fa));
+		stride = 0;    //recompile before the next run
+	}
+
+	int                size()          const {return int(automata.size());}
+	const std::string& name(int fa)    const {return automata[fa]->name;}
+
+	//Run every automaton over one simulation description (a start state
+	//  followed by inputs, all separated by semicolons); afterwards stop(fa)
+	//  is each automaton's stop state (or "None").
+	//An automaton that has no state with the start state's name starts in its
+	//  initial state, so automata with differently named states can share a
+	//  description; but if no automaton has that state (e.g., it is mistyped),
+	//  every stop state is "None".
+	void run(const StrRef& description) {
+		if (automata.empty())
+			throw ics::IcsError("MultiFA.run: no finite automata to run");
+		if (stride == 0)
+			compile();
+		split_into(description, ';', words);
+
+		bool known = false;
+		tuple.resize(automata.size());
+		for (std::size_t fa = 0; fa < automata.size(); ++fa) {
+			int start = automata[fa]->states.find(words[0]);
+			known = known || start != StringInterner::none;
+			tuple[fa] = start == StringInterner::none ? 0 : start;
+		}
+		int product = known ? product_state(tuple) : dead();
+
+		for (std::size_t i = 1; i < words.size(); ++i) {
+			int input = inputs.find(words[i]);
+			product = input == StringInterner::none ? dead() : step(product, input);
+		}
+
+		final_tuple.assign(tuples.begin() + std::size_t(product)*automata.size(),
+		                   tuples.begin() + std::size_t(product+1)*automata.size());
+	}
+
+	//The stop state of automaton fa after the last run.
+	StrRef stop(int fa) const {
+		return final_tuple[fa] == none ? StrRef("None") : automata[fa]->states.name(final_tuple[fa]);
+	}
+
+	int product_states() const {return int(tuples.size()/(automata.empty() ? 1 : automata.size()));}
+
+	//The bytes used by the cached product states' tables (at most max_cache_bytes,
+	//  unless a single product state needs more).
+	std::size_t cache_bytes() const {return (tuples.size() + transitions.size() + slots.size())*sizeof(int);}
+
+  private:
+	struct Automaton {
+		std::string      name;
+		StringInterner   states;
+		std::vector<int> local;      //shared input id -> local input id; none if not an input
+		int              width = 0;  //local input ids are 0..width-1
+		std::vector<int> edges;      //state, local input, new state triples (as read)
+		std::vector<int> next;       //states.size() x width table; none if illegal
+
+		//The local id of the shared input id, assigning the next one if it is new.
+		int local_input(int shared) {
+			if (shared >= int(local.size()))
+				local.resize(shared+1, none);
+			if (local[shared] == none)
+				local[shared] = width++;
+			return local[shared];
+		}
+
+		//The state after input (a shared id) from state s; none if illegal.
+		int step(int s, int input) const {
+			int l = local[input];
+			return s == none || l == none ? none : next[std::size_t(s)*width + l];
+		}
+	};
+
+	//Build each automaton's table, now that the shared alphabet is complete.
+	void compile() {
+		stride = inputs.size() == 0 ? 1 : inputs.size();
+		for (auto& fa : automata) {
+			fa->local.resize(inputs.size(), none);
+			fa->next.assign(std::size_t(fa->states.size())*fa->width, none);
+			for (std::size_t e = 0; e < fa->edges.size(); e += 3)
+				fa->next[std::size_t(fa->edges[e])*fa->width + fa->edges[e+1]] = fa->edges[e+2];
+		}
+		clear_products();
+	}
+
+	//The product state after input from product: cached, or computed by
+	//  stepping every automaton (none stays none: it stopped on an illegal input).
+	int step(int product, int input) {
+		int cached = transitions[std::size_t(product)*stride + input];
+		if (cached != unknown)
+			return cached;
+
+		const std::size_t k = automata.size();
+		for (std::size_t fa = 0; fa < k; ++fa)
+			tuple[fa] = automata[fa]->step(tuples[product*k + fa], input);
+		int generation = generations;
+		int answer = product_state(tuple);
+		if (generation == generations)   //product is still valid: the cache was not dropped
+			transitions[std::size_t(product)*stride + input] = answer;
+		return answer;
+	}
+
+	//The product state in which every automaton has stopped.
+	int dead() {
+		tuple.assign(automata.size(), none);
+		return product_state(tuple);
+	}
+
+	//The id of the product state for tuple, adding it (and dropping the whole
+	//  cache first if adding it would take the cache past max_cache_bytes).
+	int product_state(const std::vector<int>& t) {
+		std::size_t i = find_slot(t);
+		if (slots[i] != none)
+			return slots[i];
+		if (product_states() > 0 && cache_bytes() + added_bytes() > max_cache_bytes) {
+			clear_products();
+			i = find_slot(t);
+		}
+		if (must_grow_slots()) {
+			grow_slots();
+			i = find_slot(t);
+		}
+		int id = product_states();
+		slots[i] = id;
+		tuples.insert(tuples.end(), t.begin(), t.end());
+		transitions.resize(transitions.size() + stride, unknown);
+		return id;
+	}
+
+	//Whether the slots must double before another product state is added (to
+	//  keep them at most half full).
+	bool must_grow_slots() const {return 2*std::size_t(product_states()+1) > slots.size();}
+
+	//The bytes that adding one more product state adds to cache_bytes().
+	std::size_t added_bytes() const {
+		return (automata.size() + stride + (must_grow_slots() ? slots.size() : 0))*sizeof(int);
+	}
+
+	std::size_t hash_tuple(const int* t) const {
+		std::size_t h = 2166136261u;
+		for (std::size_t fa = 0; fa < automata.size(); ++fa)
+			h = (h ^ std::size_t(t[fa] + 1)) * 16777619u;
+		return h;
+	}
+
+	std::size_t find_slot(const std::vector<int>& t) const {
+		const std::size_t k = automata.size(), mask = slots.size()-1;
+		std::size_t i = hash_tuple(t.data()) & mask;
+		while (slots[i] != none && !std::equal(t.begin(), t.end(), tuples.begin() + std::size_t(slots[i])*k))
+			i = (i+1) & mask;
+		return i;
+	}
+
+	void grow_slots() {
+		const std::size_t k = automata.size();
+		slots.assign(2*slots.size(), none);
+		const std::size_t mask = slots.size()-1;
+		for (int id = 0; id < product_states(); ++id) {
+			std::size_t i = hash_tuple(&tuples[std::size_t(id)*k]) & mask;
+			while (slots[i] != none)
+				i = (i+1) & mask;
+			slots[i] = id;
+		}
+	}
+
+	void clear_products() {
+		tuples.clear();
+		transitions.clear();
+		slots.assign(64, none);
+		++generations;
+	}
+
+	enum {unknown = -2};   //a product transition not computed yet
+
+	std::vector<std::unique_ptr<Automaton>> automata;
+	StringInterner   inputs;               //alphabet shared by all the automata
+	std::size_t      max_cache_bytes;
+	int              stride;               //inputs.size() when compiled; 0 if not
+	int              generations = 0;      //incremented whenever the cache is dropped
+
+	std::vector<int> tuples;               //automata.size() states per product state
+	std::vector<int> transitions;          //product_states() x stride; unknown if not computed
+	std::vector<int> slots;                //open addressing: product state ids by tuple
+
+	std::vector<StrRef> words;             //scratch: the current description
+	std::vector<int>    tuple;             //scratch: the tuple being built
+	std::vector<int>    final_tuple;       //each automaton's state after the last run
+};
+
+}
+
+#endif /* MULTI_FA_HPP_ */
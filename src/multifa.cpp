@@ -0,0 +1,62 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "ics46goody.hpp"
+#include "string_pool.hpp"
+#include "profile.hpp"
+#include "output.hpp"
+#include "multi_fa.hpp"
+
+
+//Prompt the user for the names of any number of files describing finite
+//  automata (separated by semicolons) and read them all.
+//Prompt the user for a file containing any number of simulation descriptions,
+//  one per line; each description contains a start state followed by its
+//  inputs, all separated by semicolons.
+//Repeatedly read a description, print it, run every finite automaton over it
+//  (in one pass over the inputs) and print each one's Stop state (which may be
+//  "None"); an automaton without a state named by the description starts in
+//  the first state in its file, unless no automaton has that state: then every
+//  Stop state is "None".
+#ifndef DS_NO_MAIN
+int main() {
+ DS_PROFILE_PROGRAM("multifa");
+ try {
+
+	    ds::MultiFA fas;
+	    std::string names = ics::prompt_string("Enter the file names of Finite Automata (separated by ;)","faparity.txt;fadivisibleby3.txt");
+	    std::vector<ds::StrRef> words;
+	    {
+	      DS_PROFILE_PHASE(read);
+	      ds::split_into(names,';',words);
+	      for (const auto& name : words) {
+	        std::ifstream text_file(name.str().c_str());
+	        if (!text_file)
+	          throw ics::IcsError("cannot open finite automaton file " + name.str());
+	        fas.add(name.str(),text_file);
+	      }
+	    }
+
+	    std::ifstream text_file_inputs;
+	    ics::safe_open(text_file_inputs,"\nEnter the name of the file with the start-state and input","fainputparity.txt");
+
+	    std::string line;
+	    while (getline(text_file_inputs,line)) {
+	      ds::out() << "\nStarting new simulation with description: " << line << '\n';
+	      {
+	        DS_PROFILE_PHASE(process);
+	        fas.run(line);
+	      }
+	      DS_PROFILE_PHASE(print);
+	      for (int fa = 0; fa < fas.size(); ++fa)
+	        ds::out() << "  " << fas.name(fa) << ": Stop state = " << fas.stop(fa) << '\n';
+	    }
+
+ } catch (ics::IcsError& e) {
+   ds::out() << e.what() << '\n';
+ }
+
+ return 0;
+}
+#endif
@@ -8,6 +8,10 @@
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "string_pool.hpp"
+#include "profile.hpp"
+#include "output.hpp"
+#include "trace.hpp"
 
 
 typedef ics::ArraySet<std::string>                     States;
@@ -33,21 +37,21 @@ typedef ics::ArrayQueue<Transitions>                    TransitionsQueue;
 //  Map with each input in that state (keys) and the resulting set of states it
 //  can lead to.
 const NDFA read_ndfa(std::ifstream &file) {
+	DS_PROFILE_PHASE(read);
 
 	NDFA ndfa;
 	std::string line;
+	std::vector<ds::StrRef> words; //reused for every line
 
 	while (getline(file,line))
 	{
-		std::vector<std::string> words = ics::split(line,";");
-		std::string state = words[0];
-		InputStatesMap inputSM;
-		for (int i = 1; i < inputSM.size(); i += 2) {
-		  std::string input     = words[i];
-		  std::string new_state = words[i+1];
-		  inputSM[input].insert(new_state);
+		ds::split_into(line,';',words);
+		InputStatesMap& inputSM = ndfa[words[0].str()];
+		DS_PROFILE_COUNT(inserts,1);
+		for (std::size_t i = 1; i+1 < words.size(); i += 2) {
+		  inputSM[words[i].str()].insert(words[i+1].str());
+		  DS_PROFILE_COUNT(inserts,2);
 		}
-		ndfa[state] = inputSM;
 	}
 
 	file.close();
@@ -60,13 +64,14 @@ const NDFA read_ndfa(std::ifstream &file) {
 //  alphabetical order of the states: each line has a state, the text
 //  "transitions:" and the Map of its transitions.
 void print_ndfa(const NDFA& ndfa) {
-	std::cout << "Non_Deterministic Finite Automaton Description" << std::endl;
-	for(auto i: ndfa)
+	DS_PROFILE_PHASE(print);
+	ds::out() << "Non_Deterministic Finite Automaton Description\n";
+	for(const auto& i: ndfa)
 	{
-		std::cout << "   ";
-		std::cout << i.first << " transitions: " << i.second << std::endl;
+		ds::out() << "   ";
+		ds::out() << i.first << " transitions: " << i.second << '\n';
 	}
-	std::cout << std::endl;
+	ds::out() << '\n';
 }
 
 
@@ -77,6 +82,7 @@ void print_ndfa(const NDFA& ndfa) {
 //If any input i is illegal (does not lead to any state in the non-deterministic finite
 //  automaton), ignore it.
 TransitionsQueue process(const NDFA& ndfa, std::string state, const InputsQueue& inputs) {
+	DS_PROFILE_PHASE(process);
 
 	TransitionsQueue answer;
 	States initialState;
@@ -84,11 +90,13 @@ TransitionsQueue process(const NDFA& ndfa, std::string state, const InputsQueue&
 	initialState.insert(state);
 	answer.enqueue(Transitions("", (initialState)));
 
-	for (auto x : inputs)
+	for (const auto& x : inputs)
 	{
+		DS_PROFILE_COUNT(lookups,2);
 		if((ndfa[state].has_key(x)))
 		{
 			answer.enqueue(Transitions(x, ndfa[state][x]));
+			DS_PROFILE_COUNT(lookups,2);
 			//std::cout << "answer after enqueue: " << answer << std::endl;
 		}
 		else
@@ -104,20 +112,27 @@ TransitionsQueue process(const NDFA& ndfa, std::string state, const InputsQueue&
 //Print the Start state on the first line; then print each input and the
 //  resulting new states indented on subsequent lines; on the last line, print
 //  the Stop state.
-void interpret(TransitionsQueue& tq) {  //or TransitionsQueue or TransitionsQueue&&
-
+//If trace is not nullptr, also record the simulation in it.
+void interpret(TransitionsQueue& tq, ds::TraceWriter* trace = nullptr) {  //or TransitionsQueue or TransitionsQueue&&
+	DS_PROFILE_PHASE(print);
 	std::string lastState;
-	std::cout << "Start state = " << tq.peek().second << std::endl;
+	ds::out() << "Start state = " << tq.peek().second << '\n';
+	if (trace != nullptr)
+		trace->start_set(tq.peek().second);
 
-	for (auto i : tq)
+	for (const auto& i : tq)
 	{
 		if (i.first != "")
 		{
-			std::cout << " Input = " << i.first << "; new state = " << i.second << std::endl;
+			ds::out() << " Input = " << i.first << "; new state = " << i.second << '\n';
 			lastState = to_string(i.second);
+			if (trace != nullptr)
+				trace->transition_set(i.first, i.second);
 		}
 	}
-	std::cout << "Stop state = " << lastState << std::endl;
+	ds::out() << "Stop state = " << lastState << '\n';
+	if (trace != nullptr)
+		trace->end();
 }
 
 
@@ -129,31 +144,43 @@ void interpret(TransitionsQueue& tq) {  //or TransitionsQueue or TransitionsQueu
 //  semicolons.
 //Repeatedly read a description, print that description, put each input in a
 //  Queue, process the Queue and print the results in a nice form.
+#ifndef DS_NO_MAIN
 int main() {
+ DS_PROFILE_PROGRAM("ndfa");
  try {
 
 		std::ifstream text_file;
 		ics::safe_open(text_file,"Enter the name of a file with a Non-Deterministic Finite Automaton","ndfaendin01.txt");
 		NDFA f = read_ndfa(text_file);
 		print_ndfa(f);
+		ds::out().flush();
 
 		std::ifstream text_file_inputs;
 		ics::safe_open(text_file_inputs,"\nEnter the name of a file with the start-states and input","ndfainputendin01.txt");
 
 		std::string line;
+		std::vector<ds::StrRef> state_inputs;
+		InputsQueue inputs;
+		std::unique_ptr<ds::TraceWriter> trace = ds::open_trace(ds::TraceWriter::kind_ndfa);
 
 		while (getline(text_file_inputs,line)) {
-		  std::cout << "\nStarting new simulation with description: " << line << std::endl;
-		  std::vector<std::string> state_inputs = ics::split(line,";");
-		  InputsQueue inputs;
-		  for (int i = 1; i < state_inputs.size(); i++)
-			  inputs.enqueue(state_inputs[i]);
-		  TransitionsQueue t = process(f,state_inputs[0],inputs);
-		  interpret(t);
+		  ds::out() << "\nStarting new simulation with description: " << line << '\n';
+		  if (trace)
+			  trace->description(line);
+		  {
+			  DS_PROFILE_PHASE(build);
+			  ds::split_into(line,';',state_inputs);
+			  inputs.clear();
+			  for (std::size_t i = 1; i < state_inputs.size(); i++)
+				  inputs.enqueue(state_inputs[i].str());
+		  }
+		  TransitionsQueue t = process(f,state_inputs[0].str(),inputs);
+		  interpret(t,trace.get());
 		}
  } catch (ics::IcsError& e) {
-   std::cout << e.what() << std::endl;
+   ds::out() << e.what() << '\n';
  }
 
  return 0;
 }
+#endif
@@ -0,0 +1,99 @@
+#ifndef ORDERED_VIEW_HPP_
+#define ORDERED_VIEW_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+
+//Ordered views of the entries in an ics container, for printing them in order
+//  without copying the container (and every value in it) into an
+//  ics::ArrayPriorityQueue: a view is a vector of pointers to the entries, so
+//  it is only valid while the container is unchanged.
+//less(a,b) returns true if a should come before b, like the gt functions the
+//  programs give to ics::ArrayPriorityQueue.
+namespace ds {
+
+
+template<class Container>
+using EntryOf = typename std::remove_cv<typename std::remove_reference<
+                  decltype(*std::declval<const Container&>().begin())>::type>::type;
+
+
+//All the entries, sorted by less (entries that are equal stay in iteration order).
+template<class Container, class Less>
+std::vector<const EntryOf<Container>*> sorted_view(const Container& c, Less less) {
+	typedef const EntryOf<Container>* Ptr;
+	std::vector<Ptr> answer;
+	answer.reserve(c.size());
+	for (const auto& e : c)
+		answer.push_back(&e);
+	std::stable_sort(answer.begin(), answer.end(), [&less] (Ptr a, Ptr b) {return less(*a,*b);});
+	return answer;
+}
+
+
+//The first k entries in less order (all of them, if there are fewer), in that
+//  order: always the first k entries of sorted_view(c,less), because ties are
+//  broken by iteration order. A binary heap of the best k (iteration index,
+//  pointer) pairs seen so far holds them, so this takes O(n log k) time and
+//  O(k) space.
+template<class Container, class Less>
+std::vector<const EntryOf<Container>*> top_k(const Container& c, std::size_t k, Less less) {
+	typedef const EntryOf<Container>* Ptr;
+	typedef std::pair<std::size_t,Ptr> Indexed;
+	auto before = [&less] (const Indexed& a, const Indexed& b) {
+		return less(*a.second,*b.second) || (!less(*b.second,*a.second) && a.first < b.first);
+	};
+	std::vector<Ptr> answer;
+	if (k == 0)
+		return answer;
+	std::vector<Indexed> heap;   //heap.front() is the last of the best k
+	heap.reserve(k);
+	std::size_t index = 0;
+	for (const auto& e : c) {
+		Indexed entry(index++, &e);
+		if (heap.size() < k) {
+			heap.push_back(entry);
+			std::push_heap(heap.begin(), heap.end(), before);
+		} else if (before(entry, heap.front())) {
+			std::pop_heap(heap.begin(), heap.end(), before);
+			heap.back() = entry;
+			std::push_heap(heap.begin(), heap.end(), before);
+		}
+	}
+	std::sort_heap(heap.begin(), heap.end(), before);
+	answer.reserve(heap.size());
+	for (const Indexed& i : heap)
+		answer.push_back(i.second);
+	return answer;
+}
+
+
+//The first k entries in less order if k > 0, otherwise all of them.
+template<class Container, class Less>
+std::vector<const EntryOf<Container>*> ordered(const Container& c, int k, Less less) {
+	return k > 0 ? top_k(c, k, less) : sorted_view(c, less);
+}
+
+
+//Returns whether a comes before b in lexical order: the first values that
+//  differ decide, and a queue that is a prefix of the other comes first.
+//Only iterators are used, so the queues are not changed (or copied).
+template<class Queue>
+bool lexically_less(const Queue& a, const Queue& b) {
+	auto i = a.begin(), i_end = a.end();
+	auto j = b.begin(), j_end = b.end();
+	for (; i != i_end && j != j_end; ++i, ++j) {
+		if (*i < *j)
+			return true;
+		if (*j < *i)
+			return false;
+	}
+	return i == i_end && j != j_end;
+}
+
+}
+
+#endif /* ORDERED_VIEW_HPP_ */
@@ -0,0 +1,99 @@
+#ifndef OUTPUT_HPP_
+#define OUTPUT_HPP_
+
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include "string_pool.hpp"
+
+
+//Buffered output that replaces std::cout (and its std::endl flushes) in the
+//  programs: text accumulates in one large reusable buffer and is written only
+//  when the buffer fills or flush is called (before prompting the user).
+//Strings, characters and integers are formatted directly into the buffer; any
+//  other value (e.g., an ics container) is formatted with its operator << into a
+//  reusable std::ostringstream, so its text is exactly what std::cout printed.
+namespace ds {
+
+
+class OutBuffer {
+  public:
+	explicit OutBuffer(std::FILE* file, std::size_t capacity = 64*1024)
+	  : file(file), buffer(new char[capacity]), capacity(capacity), used(0) {}
+	OutBuffer(const OutBuffer&) = delete;
+	OutBuffer& operator = (const OutBuffer&) = delete;
+	~OutBuffer() {flush(); delete[] buffer;}
+
+	//Write the buffered text to the file (and flush the file, so that it is
+	//  visible before any prompt).
+	void flush() {
+		if (used > 0)
+			std::fwrite(buffer, 1, used, file);
+		used = 0;
+		std::fflush(file);
+	}
+
+	OutBuffer& write(const char* data, std::size_t n) {
+		if (used + n > capacity) {
+			if (used > 0)
+				std::fwrite(buffer, 1, used, file);
+			used = 0;
+			if (n > capacity) {
+				std::fwrite(data, 1, n, file);
+				return *this;
+			}
+		}
+		std::memcpy(buffer+used, data, n);
+		used += n;
+		return *this;
+	}
+
+	OutBuffer& operator << (char c)                 {return write(&c, 1);}
+	OutBuffer& operator << (const StrRef& s)        {return write(s.data(), s.size());}
+	OutBuffer& operator << (const std::string& s)   {return write(s.data(), s.size());}
+	OutBuffer& operator << (const char* s)          {return write(s, std::strlen(s));}
+
+	OutBuffer& operator << (int n)                  {return integer(n < 0, n < 0 ? 0ul-(unsigned long)n : (unsigned long)n);}
+	OutBuffer& operator << (long n)                 {return integer(n < 0, n < 0 ? 0ul-(unsigned long)n : (unsigned long)n);}
+	OutBuffer& operator << (unsigned int n)         {return integer(false, n);}
+	OutBuffer& operator << (unsigned long n)        {return integer(false, n);}
+
+	template<class T>
+	OutBuffer& operator << (const T& value) {
+		scratch.str("");
+		scratch << value;
+		const std::string& text = scratch.str();
+		return write(text.data(), text.size());
+	}
+
+  private:
+	OutBuffer& integer(bool negative, unsigned long magnitude) {
+		char digits[24];
+		char* p = digits + sizeof(digits);
+		do {
+			*--p = char('0' + magnitude%10);
+			magnitude /= 10;
+		} while (magnitude != 0);
+		if (negative)
+			*--p = '-';
+		return write(p, digits+sizeof(digits)-p);
+	}
+
+	std::FILE*         file;
+	char*              buffer;
+	std::size_t        capacity;
+	std::size_t        used;
+	std::ostringstream scratch;
+};
+
+
+//The programs' standard output; it is flushed when the program exits.
+inline OutBuffer& out() {
+	static OutBuffer buffer(stdout);
+	return buffer;
+}
+
+}
+
+#endif /* OUTPUT_HPP_ */
@@ -0,0 +1,129 @@
+#ifndef PROFILE_HPP_
+#define PROFILE_HPP_
+
+
+//Compile-time switchable instrumentation.
+//Build with -DDS_PROFILE to count container lookups/inserts and the strings
+//  (and their bytes) materialized from input tokens, and to time each phase of
+//  a program; at exit a summary is written to std::cerr and as JSON to the file
+//  named by the DS_PROFILE_JSON environment variable (default profile.json).
+//Without DS_PROFILE every macro below expands to nothing, so the instrumented
+//  code compiles exactly as if it were not there.
+//DS_PROFILE_PHASE and DS_PROFILE_COUNT are thread-safe (the totals are
+//  atomic), so code called from many threads at once, as in the query server,
+//  can be profiled; DS_PROFILE_PROGRAM must be called before any threads start.
+//
+//  DS_PROFILE_PROGRAM("fa");        name used in the summary (call in main)
+//  DS_PROFILE_PHASE(read);          time the rest of the enclosing scope as
+//                                   phase read, build, process or print
+//  DS_PROFILE_COUNT(lookups,1);     add to counter lookups, inserts, strings
+//                                   or string_bytes
+//  DS_PROFILE_REPORT();             report now (for a program that does not
+//                                   exit normally, e.g. the query server)
+
+#ifdef DS_PROFILE
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+
+namespace ds {
+namespace profile {
+
+enum class Phase   {read, build, process, print, count};
+enum class Counter {lookups, inserts, strings, string_bytes, count};
+
+static const char* const phase_names  [] = {"read", "build", "process", "print"};
+static const char* const counter_names[] = {"lookups", "inserts", "strings", "string_bytes"};
+
+
+class Profile {
+  public:
+	Profile() : program("program") {
+		for (int p = 0; p < int(Phase::count); ++p)
+			phase_ns[p] = phase_calls[p] = 0;
+		for (int c = 0; c < int(Counter::count); ++c)
+			counters[c] = 0;
+	}
+	~Profile() {report();}
+
+	//Totals are only summed here (and read at exit), so relaxed order is enough
+	void count(Counter c, std::int64_t n) {
+		counters[int(c)].fetch_add(n, std::memory_order_relaxed);
+	}
+	void add(Phase p, std::chrono::nanoseconds time) {
+		phase_ns   [int(p)].fetch_add(time.count(), std::memory_order_relaxed);
+		phase_calls[int(p)].fetch_add(1,            std::memory_order_relaxed);
+	}
+
+	void report() const {
+		std::cerr << "\nProfile of " << program << std::endl;
+		for (int p = 0; p < int(Phase::count); ++p)
+			std::cerr << "   " << phase_names[p] << ": " << phase_ns[p].load()/1000 << " us in "
+			          << phase_calls[p].load() << " calls" << std::endl;
+		for (int c = 0; c < int(Counter::count); ++c)
+			std::cerr << "   " << counter_names[c] << ": " << counters[c].load() << std::endl;
+
+		const char* file_name = std::getenv("DS_PROFILE_JSON");
+		std::ofstream json(file_name != nullptr ? file_name : "profile.json");
+		json << "{\"program\":\"" << program << "\",\"phases\":{";
+		for (int p = 0; p < int(Phase::count); ++p)
+			json << (p == 0 ? "" : ",") << "\"" << phase_names[p] << "\":{\"ns\":" << phase_ns[p].load()
+			     << ",\"calls\":" << phase_calls[p].load() << "}";
+		json << "},\"counters\":{";
+		for (int c = 0; c < int(Counter::count); ++c)
+			json << (c == 0 ? "" : ",") << "\"" << counter_names[c] << "\":" << counters[c].load();
+		json << "}}" << std::endl;
+	}
+
+	const char*  program;
+
+  private:
+	std::atomic<std::int64_t> phase_ns   [int(Phase::count)];
+	std::atomic<std::int64_t> phase_calls[int(Phase::count)];
+	std::atomic<std::int64_t> counters   [int(Counter::count)];
+};
+
+
+//The one Profile for the program; it reports when it is destroyed at exit.
+inline Profile& global() {
+	static Profile profile;
+	return profile;
+}
+
+
+class PhaseTimer {
+  public:
+	explicit PhaseTimer(Phase p) : phase(p), start(std::chrono::steady_clock::now()) {}
+	~PhaseTimer() {global().add(phase, std::chrono::steady_clock::now()-start);}
+
+  private:
+	Phase phase;
+	std::chrono::steady_clock::time_point start;
+};
+
+}
+}
+
+#define DS_PROFILE_CONCAT_(a,b) a##b
+#define DS_PROFILE_CONCAT(a,b)  DS_PROFILE_CONCAT_(a,b)
+
+#define DS_PROFILE_PROGRAM(name)   (ds::profile::global().program = (name))
+#define DS_PROFILE_PHASE(phase)    ds::profile::PhaseTimer DS_PROFILE_CONCAT(ds_profile_phase_,__LINE__)(ds::profile::Phase::phase)
+#define DS_PROFILE_COUNT(counter,n) ds::profile::global().count(ds::profile::Counter::counter, (n))
+#define DS_PROFILE_REPORT()         ds::profile::global().report()
+
+#else
+
+#define DS_PROFILE_PROGRAM(name)    ((void)0)
+#define DS_PROFILE_PHASE(phase)     ((void)0)
+#define DS_PROFILE_COUNT(counter,n) ((void)0)
+#define DS_PROFILE_REPORT()         ((void)0)
+
+#endif /* DS_PROFILE */
+
+#endif /* PROFILE_HPP_ */
@@ -8,6 +8,10 @@
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "string_pool.hpp"
+#include "profile.hpp"
+#include "output.hpp"
+#include "ordered_view.hpp"
 
 
 typedef ics::ArraySet<std::string>          NodeSet;
@@ -17,7 +21,6 @@ typedef ics::pair<std::string,NodeSet>      GraphEntry;
 bool graph_entry_gt (const GraphEntry& a, const GraphEntry& b)
 {return a.first<b.first;}
 
-typedef ics::ArrayPriorityQueue<GraphEntry,graph_entry_gt> GraphPQ;
 typedef ics::ArrayMap<std::string,NodeSet>  Graph;
 
 
@@ -26,12 +29,16 @@ typedef ics::ArrayMap<std::string,NodeSet>  Graph;
 //  Graph (Map) of each node name associated with the Set of all node names to
 //  which there is an edge from the key node name.
 Graph read_graph(std::ifstream &file) {
+	DS_PROFILE_PHASE(read);
 	Graph graph;
 	std::string line; //edges
+	std::vector<ds::StrRef> words; //reused for every line
 
 	while(getline(file, line)){
-		std::vector<std::string> words = ics::split(line,";");
-		graph[words[0]].insert(words[1]);
+		if (ds::split_into(line,';',words) < 2)
+			continue;
+		graph[words[0].str()].insert(words[1].str());
+		DS_PROFILE_COUNT(inserts,2);
 	}
 
 	file.close();
@@ -44,20 +51,15 @@ Graph read_graph(std::ifstream &file) {
 //Use a "->" to separate the source node name from the Set of destination
 //  node names to which it has an edge.
 void print_graph(const Graph& graph) {
+	DS_PROFILE_PHASE(print);
 
-	std::cout << "\nGraph: source -> {destination} edges" << std::endl;
-	GraphPQ answer;
+	ds::out() << "\nGraph: source -> {destination} edges\n";
 
-	for (auto i : graph)
+	for (const GraphEntry* entry : ds::sorted_view(graph, graph_entry_gt))
 	{
-		answer.enqueue(i);
+		ds::out() << "  " << entry->first << " -> " << entry->second << '\n';
 	}
-	while(!answer.empty())
-	{
-		GraphEntry entry = answer.dequeue();
-		std::cout << "  " << entry.first << " -> " << entry.second << std::endl;
-	}
-	std::cout << "\n";
+	ds::out() << "\n";
 }
 
 
@@ -66,6 +68,7 @@ void print_graph(const Graph& graph) {
 //Use a local Set and a Queue to respectively store the reachable nodes and
 //  the nodes that are being explored.
 NodeSet reachable(const Graph& graph, std::string start) {
+	DS_PROFILE_PHASE(process);
 
 
 	NodeSet answer;
@@ -76,14 +79,18 @@ NodeSet reachable(const Graph& graph, std::string start) {
 
 	while(!explored.empty())
 	{
+		DS_PROFILE_COUNT(lookups,1);
 		if(graph.has_key(explored.peek()))
 		{
-			for(auto i : graph[explored.peek()])
+			DS_PROFILE_COUNT(lookups,1);
+			for(const auto& i : graph[explored.peek()])
 			{
+				DS_PROFILE_COUNT(lookups,1);
 				if(!answer.contains(i))
 				{
 					answer.insert(i);
 					explored.enqueue(i);
+					DS_PROFILE_COUNT(inserts,2);
 				}
 			}
 		}
@@ -100,7 +107,9 @@ NodeSet reachable(const Graph& graph, std::string start) {
 //  starting node name and then either print an error (if that the node name
 //  is not a source node in the graph) or print the Set of node names
 //  reachable from it by using the edges in the Graph.
+#ifndef DS_NO_MAIN
 int main() {
+ DS_PROFILE_PROGRAM("reachable");
  try {
 	  std::ifstream text_file;
 	  ics::safe_open(text_file, "Enter the name of a file with a graph", "graph1.txt");
@@ -108,6 +117,7 @@ int main() {
 	  print_graph(g);
 
 	  while(true){
+		  ds::out().flush();
 		  std::string node = ics::prompt_string("\nEnter the name of a starting node (enter quit to quit)");
 		  if (node == "quit")
 		  {
@@ -119,20 +129,22 @@ int main() {
 			  {
 				  break;
 			  }
-			  std::cout << " ";
-			  std::cout << node << " is not a source node name in the graph" << std::endl;
+			  ds::out() << " ";
+			  ds::out() << node << " is not a source node name in the graph\n";
 		  }
 
 		  else
 		  {
 			  NodeSet answer = reachable(g, node);
-			  std::cout << "Reachable from node name " << node << " = " << answer << std::endl;
+			  DS_PROFILE_PHASE(print);
+			  ds::out() << "Reachable from node name " << node << " = " << answer << '\n';
 		  }
 	  }
 
  } catch (ics::IcsError& e) {
-   std::cout << e.what() << std::endl;
+   ds::out() << e.what() << '\n';
  }
 
  return 0;
 }
+#endif
@@ -9,6 +9,10 @@
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "string_pool.hpp"
+#include "profile.hpp"
+#include "output.hpp"
+#include "ordered_view.hpp"
 
 
 typedef ics::ArrayQueue<std::string>              CandidateQueue;
@@ -17,10 +21,8 @@ typedef ics::ArrayMap<std::string,int>            CandidateTally;
 
 typedef ics::ArrayMap<std::string,CandidateQueue> Preferences;
 typedef ics::pair<std::string,CandidateQueue>     PreferencesEntry;
-typedef ics::ArrayPriorityQueue<PreferencesEntry> PreferencesEntryPQ; //Must supply gt at construction
 
 typedef ics::pair<std::string,int>                TallyEntry;
-typedef ics::ArrayPriorityQueue<TallyEntry>       TallyEntryPQ;
 
 
 
@@ -31,23 +33,24 @@ typedef ics::ArrayPriorityQueue<TallyEntry>       TallyEntryPQ;
 //  by semicolons), and return a Map of preferences: a Map whose keys are
 //  voter names and whose values are a queue of candidate preferences.
 Preferences read_voter_preferences(std::ifstream &file) {
+	  DS_PROFILE_PHASE(read);
 
 	  Preferences answer;
 	  std::string line;
+	  std::vector<ds::StrRef> words; //reused for every line
 
 	  while (getline(file,line)) {
 
-	    std::vector<std::string> words = ics::split(line,";");
-	    std::string voter = words[0];
+	    ds::split_into(line,';',words);
 
-	    CandidateQueue queue;
+	    CandidateQueue& queue = answer[words[0].str()];
+	    queue.clear();
 
-	    for (int i = 1; i < words.size(); ++i)
+	    for (std::size_t i = 1; i < words.size(); ++i)
 	    {
-	      queue.enqueue(words[i]);
+	      queue.enqueue(words[i].str());
 	    }
-
-	    answer.put(voter,queue);
+	    DS_PROFILE_COUNT(inserts,words.size());
 	  }
 
 	  file.close();
@@ -60,17 +63,18 @@ Preferences read_voter_preferences(std::ifstream &file) {
 //  order according to the voter.
 //Use a "->" to separate the voter name from the Queue of candidates.
 void print_voter_preferences(const Preferences& preferences) {
+	DS_PROFILE_PHASE(print);
 
-	std::cout << "\n" << "Voter Preferences" << std::endl;
+	ds::out() << "\n" << "Voter Preferences\n";
 
-	//Implement sort function to PQ elements accessing first items of each
-	PreferencesEntryPQ sortedCollection(preferences, [](const PreferencesEntry& x,
+	//Sort (pointers to) the entries by their first items: the voter names
+	auto sortedCollection = ds::sorted_view(preferences, [](const PreferencesEntry& x,
 			const PreferencesEntry& y){return x.first < y.first;});
 
-	for (PreferencesEntry& keyVal : sortedCollection) {
-		std::cout << "   ";
+	for (const PreferencesEntry* keyVal : sortedCollection) {
+		ds::out() << "   ";
 					//voter name           //queue of candidates
-		std::cout << keyVal.first << " -> " << keyVal.second << std::endl;
+		ds::out() << keyVal->first << " -> " << keyVal->second << '\n';
 
 	}
 }
@@ -82,19 +86,20 @@ void print_voter_preferences(const Preferences& preferences) {
 //  other times by decreasing votes for the candidate.
 //Use a "->" to separate the candidat name from the number of votes they
 //  received.
-void print_tally(std::string message, const CandidateTally& tally, bool (*has_higher_priority)(const TallyEntry& i,const TallyEntry& j)) {
+//If top > 0, print only the first top entries in that order.
+void print_tally(std::string message, const CandidateTally& tally, bool (*has_higher_priority)(const TallyEntry& i,const TallyEntry& j), int top = 0) {
+	DS_PROFILE_PHASE(print);
 
-	std::cout << "\n" << message << std::endl;
+	ds::out() << "\n" << message << '\n';
 
-	//Implement prioritizer function taking tally and priority as two args
-	TallyEntryPQ prioritizedCollection(tally, has_higher_priority);
+	//Order (pointers to) the entries by priority: all, or just the first top
+	auto prioritizedCollection = ds::ordered(tally, top, has_higher_priority);
 
-	for(auto& t : prioritizedCollection)
+	for(const TallyEntry* t : prioritizedCollection)
 	{
-		//std::cout << "t: " << t << std::endl;
-		std::cout << "   ";
+		ds::out() << "   ";
 			     //candidate name	 //number of votes
-		std::cout << t.first << " -> " << t.second << std::endl;
+		ds::out() << t->first << " -> " << t->second << '\n';
 
 	}
 
@@ -108,21 +113,25 @@ void print_tally(std::string message, const CandidateTally& tally, bool (*has_hi
 //Each voter should tally one vote: for their highest-ranked candidate who is
 //  still in the the election.
 CandidateTally evaluate_ballot(const Preferences& preferences, const CandidateSet& candidates) {
+	DS_PROFILE_PHASE(process);
 
 	CandidateTally answer;
 	int setVal = 0;
 
 	for (auto& i : candidates)
 		answer[i] = setVal;
+	DS_PROFILE_COUNT(inserts,candidates.size());
 
 	for (auto& i : preferences)
 	{
 		//std::cout << "i.second: " << i.second << std::endl;
 		for (auto& j : i.second)
 		{
+			DS_PROFILE_COUNT(lookups,1);
 			if (candidates.contains(j))
 			{
 				answer[j] += setVal+1;
+				DS_PROFILE_COUNT(lookups,1);
 				break;
 			}
 		}
@@ -138,16 +147,17 @@ CandidateTally evaluate_ballot(const Preferences& preferences, const CandidateSe
 //  receive the same number of votes (that would be the minimum), the empty
 //  Set is returned.
 CandidateSet remaining_candidates(const CandidateTally& tally) {
+	DS_PROFILE_PHASE(process);
 
 	CandidateSet answer;
 	int minimum = std::numeric_limits<int>::max(); //really useful --
 
-	for(auto i : tally)
+	for(const auto& i : tally)
 	{
 		if(i.second < minimum)
 			minimum = i.second;
 	}
-	for(auto i : tally)
+	for(const auto& i : tally)
 	{
 		if (i.second > minimum)
 			answer.insert(i.first);
@@ -161,6 +171,8 @@ CandidateSet remaining_candidates(const CandidateTally& tally) {
 
 
 //Prompt the user for a file, create a voter preference Map, and print it.
+//Prompt the user for how many leading candidates to print in each tally with
+//  the vote count decreasing (0, the default, prints them all).
 //Determine the Set of all the candidates in the election, from this Map.
 //Repeatedly evaluate the ballot based on the candidates (still) in the
 //  election, printing the vote count (tally) two ways: with the candidates
@@ -171,17 +183,23 @@ CandidateSet remaining_candidates(const CandidateTally& tally) {
 //  continue this process until there are less than 2 candidates.
 //Print the final result: there may 1 candidate left (the winner) or 0 left
 //   (no winner).
+#ifndef DS_NO_MAIN
 int main() {
+ DS_PROFILE_PROGRAM("runoffvoting");
  try {
 	    std::ifstream text_file;
 	    ics::safe_open(text_file,"Enter voter preference file name","votepref1.txt");
+	    int top = ics::prompt_int("Enter how many leading candidates to print in numerical order (0 for all)",0);
 	    Preferences p = read_voter_preferences(text_file);
 	    print_voter_preferences(p);
 
 	    CandidateSet candidates;
-	    for (auto& voter : p)
-	      for (auto& i : voter.second)
-	        candidates.insert(i);
+	    {
+	      DS_PROFILE_PHASE(build);
+	      for (auto& voter : p)
+	        for (auto& i : voter.second)
+	          candidates.insert(i);
+	    }
 
 	    unsigned int counter = 1;
 	    while(true)
@@ -192,7 +210,7 @@ int main() {
 	    	print_tally(sstream.str(),tally,[](const TallyEntry& i,const TallyEntry& j){return (i.first == j.first ? i.second < j.second : i.first < j.first);});
 	    	sstream.str("");
 	    	sstream << "\nVote count on ballot #" << counter << " with candidates in numerical order: still in election = " << candidates;
-	    	print_tally(sstream.str(),tally,[](const TallyEntry& i,const TallyEntry& j){return (i.second == j.second ? i.first < j.first : i.second > j.second);});
+	    	print_tally(sstream.str(),tally,[](const TallyEntry& i,const TallyEntry& j){return (i.second == j.second ? i.first < j.first : i.second > j.second);},top);
 	    	candidates = remaining_candidates(tally);
 	    	counter += 1;
 
@@ -200,14 +218,14 @@ int main() {
 	    	{
 	    		for(auto winner : candidates)
 			  {
-				  std::cout << std::endl << "Winner is " << winner << std::endl;
+				  ds::out() << "\nWinner is " << winner << '\n';
 			  }
 			  break;
 	    	}
 
 	    	else if(candidates.empty())
 	    	{
-			  std::cout << std::endl << "No winner: election is a tie among candidate remaining on the last ballot." << std::endl;
+			  ds::out() << "\nNo winner: election is a tie among candidate remaining on the last ballot.\n";
 			  break;
 	    	}
 
@@ -215,7 +233,8 @@ int main() {
 	    }
 
  } catch (ics::IcsError& e) {
-   std::cout << e.what() << std::endl;
+   ds::out() << e.what() << '\n';
  }
  return 0;
 }
+#endif
@@ -0,0 +1,200 @@
+#ifndef STRING_POOL_HPP_
+#define STRING_POOL_HPP_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <iostream>
+#include "profile.hpp"
+
+
+//Shared string handling for the lab programs: a non-owning string reference,
+//  a bump arena, an interner (names <-> dense int ids), and a tokenizer that
+//  splits a line into references instead of building a fresh vector of
+//  strings for every line (as ics::split does).
+//Everything here is C++11 (the project is built with -std=c++11, so there is
+//  no std::string_view).
+namespace ds {
+
+
+//A pointer/length view of characters owned by someone else (a std::string,
+//  an Arena, ...); it is only valid as long as that owner is alive and
+//  unchanged.
+class StrRef {
+  public:
+	StrRef() : ptr(""), len(0) {}
+	StrRef(const char* p, std::size_t n) : ptr(p), len(n) {}
+	StrRef(const char* p) : ptr(p), len(std::strlen(p)) {}
+	StrRef(const std::string& s) : ptr(s.data()), len(s.size()) {}
+
+	const char* data () const {return ptr;}
+	std::size_t size () const {return len;}
+	bool        empty() const {return len == 0;}
+	char  operator[] (std::size_t i) const {return ptr[i];}
+
+	std::string str() const {
+		DS_PROFILE_COUNT(strings,1);
+		DS_PROFILE_COUNT(string_bytes,len);
+		return std::string(ptr,len);
+	}
+
+	int compare(const StrRef& rhs) const {
+		int c = std::memcmp(ptr, rhs.ptr, len < rhs.len ? len : rhs.len);
+		return c != 0 ? c : (len < rhs.len ? -1 : (len > rhs.len ? 1 : 0));
+	}
+
+	bool operator == (const StrRef& rhs) const {return len == rhs.len && std::memcmp(ptr,rhs.ptr,len) == 0;}
+	bool operator != (const StrRef& rhs) const {return !(*this == rhs);}
+	bool operator <  (const StrRef& rhs) const {return compare(rhs) < 0;}
+
+  private:
+	const char* ptr;
+	std::size_t len;
+};
+
+inline std::ostream& operator << (std::ostream& outs, const StrRef& s) {
+	return outs.write(s.data(), s.size());
+}
+
+
+//FNV-1a: cheap and good enough for the short names in these files.
+inline std::size_t hash(const StrRef& s) {
+	std::size_t h = 2166136261u;
+	for (std::size_t i = 0; i < s.size(); ++i) {
+		h ^= static_cast<unsigned char>(s[i]);
+		h *= 16777619u;
+	}
+	return h;
+}
+
+
+//Bump allocator: hands out memory from large blocks and frees it all at once
+//  when the Arena is destroyed (or reset). Nothing allocated here is moved, so
+//  StrRefs into an Arena stay valid for the Arena's lifetime.
+class Arena {
+  public:
+	explicit Arena(std::size_t block_size = 64*1024) : block_size(block_size), used(block_size) {}
+	Arena(const Arena&) = delete;
+	Arena& operator = (const Arena&) = delete;
+
+	char* allocate(std::size_t n) {
+		//Oversized requests get their own block, kept behind the current one
+		if (n > block_size/4) {
+			std::unique_ptr<char[]> big(new char[n]);
+			char* answer = big.get();
+			blocks.insert(blocks.empty() ? blocks.end() : blocks.end()-1, std::move(big));
+			return answer;
+		}
+		if (blocks.empty() || used + n > block_size) {
+			blocks.push_back(std::unique_ptr<char[]>(new char[block_size]));
+			used = 0;
+		}
+		char* answer = blocks.back().get() + used;
+		used += n;
+		return answer;
+	}
+
+	StrRef copy(const StrRef& s) {
+		char* p = allocate(s.size());
+		std::memcpy(p, s.data(), s.size());
+		return StrRef(p, s.size());
+	}
+
+	//Release everything; all StrRefs into this Arena become invalid.
+	void reset() {
+		blocks.clear();
+		used = block_size;
+	}
+
+	std::size_t block_count() const {return blocks.size();}
+
+  private:
+	std::size_t block_size;
+	std::size_t used;
+	std::vector<std::unique_ptr<char[]>> blocks;
+};
+
+
+//Maps each distinct name to a dense id (0, 1, 2, ... in order of first
+//  appearance) and back. Names are copied once into the interner's Arena, so
+//  the StrRef returned by name(id) is stable for the interner's lifetime.
+//Lookup is open addressing (linear probing) over a power-of-2 table of ids.
+class StringInterner {
+  public:
+	enum {none = -1};
+
+	StringInterner() : slots(16, none) {}
+	StringInterner(const StringInterner&) = delete;
+	StringInterner& operator = (const StringInterner&) = delete;
+
+	//Return the id of s, adding it if it is not already present.
+	int intern(const StrRef& s) {
+		if (2*(names.size()+1) > slots.size())
+			grow();
+		std::size_t i = probe(s);
+		if (slots[i] == none) {
+			slots[i] = int(names.size());
+			names.push_back(arena.copy(s));
+		}
+		return slots[i];
+	}
+
+	//Return the id of s, or none if it has never been interned.
+	int find(const StrRef& s) const {return slots[probe(s)];}
+
+	const StrRef& name(int id) const {return names[id];}
+	int           size()       const {return int(names.size());}
+
+  private:
+	std::size_t probe(const StrRef& s) const {
+		std::size_t mask = slots.size()-1;
+		std::size_t i    = hash(s) & mask;
+		while (slots[i] != none && names[slots[i]] != s)
+			i = (i+1) & mask;
+		return i;
+	}
+
+	void grow() {
+		std::vector<int> old(2*slots.size(), none);
+		old.swap(slots);
+		std::size_t mask = slots.size()-1;
+		for (int id = 0; id < int(names.size()); ++id) {
+			std::size_t i = hash(names[id]) & mask;
+			while (slots[i] != none)
+				i = (i+1) & mask;
+			slots[i] = id;
+		}
+	}
+
+	Arena               arena;
+	std::vector<StrRef> names;
+	std::vector<int>    slots;
+};
+
+
+//Split line at every occurrence of sep, storing references to the pieces in
+//  words (which is cleared first); like ics::split, adjacent separators produce
+//  empty pieces and a line always produces at least one piece.
+//Reusing the same words vector for every line means no allocation at all once
+//  its capacity has grown to the longest line; the references are only valid
+//  until line is changed.
+//Returns the number of pieces.
+inline std::size_t split_into(const StrRef& line, char sep, std::vector<StrRef>& words) {
+	words.clear();
+	const char* p   = line.data();
+	const char* end = p + line.size();
+	for (;;) {
+		const char* q = static_cast<const char*>(std::memchr(p, sep, end-p));
+		if (q == nullptr) {
+			words.push_back(StrRef(p, end-p));
+			return words.size();
+		}
+		words.push_back(StrRef(p, q-p));
+		p = q+1;
+	}
+}
+
+}
+
+#endif /* STRING_POOL_HPP_ */
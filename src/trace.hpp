@@ -0,0 +1,221 @@
+#ifndef TRACE_HPP_
+#define TRACE_HPP_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include "ics46goody.hpp"
+#include "string_pool.hpp"
+#include "output.hpp"
+
+
+//Compact binary trace of the simulations run by fa and ndfa, for offline
+//  processing; trace/trace_decode turns a trace back into exactly the text the
+//  program printed for its simulations.
+//A program writes a trace when the DS_TRACE environment variable names a file.
+//
+//Format: the header "DSTRACE" followed by a version byte (1) and the kind of
+//  automaton ('F' or 'N'), then records, each starting with a one byte tag.
+//  Numbers are unsigned LEB128 varints; a state or input is written as the id
+//  of its name, and each name is defined (by a Name record) just before the
+//  first record that uses it, so ids are 0, 1, 2, ... in order of definition.
+//
+//  'N' length bytes          Name: define the next id
+//  'D' length bytes          Description line of a new simulation
+//  'S' states                Start state
+//  'I' input states          Input and the new state(s)
+//  'X' input                 Illegal input: the simulation terminates
+//  'E'                       End of the simulation
+//
+//  states is one id for an FA; for an NDFA, a count followed by that many ids.
+namespace ds {
+
+
+class TraceWriter {
+  public:
+	static const char kind_fa   = 'F';
+	static const char kind_ndfa = 'N';
+
+	//Write a trace to file_name (creating it); throws ics::IcsError if it
+	//  cannot be created.
+	TraceWriter(const std::string& file_name, char kind) : file(std::fopen(file_name.c_str(), "wb")) {
+		if (file == nullptr)
+			throw ics::IcsError("cannot create trace file " + file_name);
+		bytes.reset(new OutBuffer(file));
+		*bytes << "DSTRACE" << char(1) << kind;
+	}
+	TraceWriter(const TraceWriter&) = delete;
+	TraceWriter& operator = (const TraceWriter&) = delete;
+	~TraceWriter() {bytes.reset(); std::fclose(file);}
+
+	void description(const StrRef& line)      {tag('D'); text(line);}
+	void start      (const StrRef& state)     {int s = id(state); tag('S'); number(s);}
+	void illegal    (const StrRef& input)     {int i = id(input); tag('X'); number(i);}
+	void end        ()                        {tag('E');}
+
+	void transition(const StrRef& input, const StrRef& state) {
+		int i = id(input), s = id(state);
+		tag('I'); number(i); number(s);
+	}
+
+	//For an NDFA: states is an ics::ArraySet of state names.
+	template<class Set>
+	void start_set(const Set& states) {
+		ids_of(states);
+		tag('S'); numbers();
+	}
+
+	template<class Set>
+	void transition_set(const StrRef& input, const Set& states) {
+		int i = id(input);
+		ids_of(states);
+		tag('I'); number(i); numbers();
+	}
+
+  private:
+	int id(const StrRef& name) {
+		int before = names.size();
+		int answer = names.intern(name);
+		if (answer == before) {
+			tag('N');
+			text(name);
+		}
+		return answer;
+	}
+
+	template<class Set>
+	void ids_of(const Set& states) {
+		set_ids.clear();
+		for (const auto& s : states)
+			set_ids.push_back(id(s));
+	}
+
+	void tag   (char t)                 {*bytes << t;}
+	void text  (const StrRef& s)        {number(s.size()); *bytes << s;}
+	void numbers()                      {number(set_ids.size()); for (int i : set_ids) number(i);}
+
+	void number(std::uint64_t n) {
+		while (n >= 0x80) {
+			*bytes << char((n & 0x7f) | 0x80);
+			n >>= 7;
+		}
+		*bytes << char(n);
+	}
+
+	std::FILE*                 file;
+	std::unique_ptr<OutBuffer> bytes;
+	StringInterner             names;
+	std::vector<int>           set_ids;
+};
+
+
+//Reads the records of a trace written by TraceWriter, one at a time.
+class TraceReader {
+  public:
+	//Open file_name and check its header; throws ics::IcsError if it is not a
+	//  trace.
+	explicit TraceReader(const std::string& file_name) : file(std::fopen(file_name.c_str(), "rb")) {
+		if (file == nullptr)
+			throw ics::IcsError("cannot open trace file " + file_name);
+		char header[9];
+		if (std::fread(header, 1, 9, file) != 9 || std::string(header, 7) != "DSTRACE" || header[7] != 1
+		    || (header[8] != TraceWriter::kind_fa && header[8] != TraceWriter::kind_ndfa)) {
+			std::fclose(file);
+			throw ics::IcsError(file_name + " is not a trace file");
+		}
+		kind = header[8];
+	}
+	TraceReader(const TraceReader&) = delete;
+	TraceReader& operator = (const TraceReader&) = delete;
+	~TraceReader() {std::fclose(file);}
+
+	char kind;             //TraceWriter::kind_fa or TraceWriter::kind_ndfa
+
+	//The current record (after next returns true): tag is 'D', 'S', 'I', 'X'
+	//  or 'E' (Name records are absorbed into names); line is the description,
+	//  input the input name, and states the state name(s).
+	char                     tag;
+	std::string              line;
+	std::string              input;
+	std::vector<std::string> states;
+
+	//Read the next record; false at the end of the trace.
+	bool next() {
+		for (;;) {
+			int t = std::getc(file);
+			if (t == EOF)
+				return false;
+			tag = char(t);
+			switch (tag) {
+				case 'N': names.push_back(text());                           break;
+				case 'D': line = text();                                     return true;
+				case 'S': read_states();                                     return true;
+				case 'I': input = name(number()); read_states();             return true;
+				case 'X': input = name(number());                            return true;
+				case 'E':                                                    return true;
+				default : throw ics::IcsError("corrupt trace: unknown record " + std::to_string(t));
+			}
+		}
+	}
+
+  private:
+	std::uint64_t number() {
+		std::uint64_t answer = 0;
+		for (int shift = 0; ; shift += 7) {
+			int b = std::getc(file);
+			if (b == EOF || shift > 63)
+				throw ics::IcsError("corrupt trace: truncated number");
+			answer |= std::uint64_t(b & 0x7f) << shift;
+			if ((b & 0x80) == 0)
+				return answer;
+		}
+	}
+
+	//Read the text in chunks, so that a corrupt length fails at the end of the
+	//  file instead of allocating whatever the length says.
+	std::string text() {
+		std::uint64_t length = number();
+		std::string answer;
+		char chunk[4096];
+		while (length > 0) {
+			std::size_t n = length < sizeof(chunk) ? std::size_t(length) : sizeof(chunk);
+			if (std::fread(chunk, 1, n, file) != n)
+				throw ics::IcsError("corrupt trace: truncated text");
+			answer.append(chunk, n);
+			length -= n;
+		}
+		return answer;
+	}
+
+	const std::string& name(std::uint64_t id) const {
+		if (id >= names.size())
+			throw ics::IcsError("corrupt trace: undefined name " + std::to_string(id));
+		return names[id];
+	}
+
+	void read_states() {
+		states.clear();
+		std::uint64_t count = kind == TraceWriter::kind_fa ? 1 : number();
+		for (std::uint64_t i = 0; i < count; ++i)
+			states.push_back(name(number()));
+	}
+
+	std::FILE*               file;
+	std::vector<std::string> names;
+};
+
+
+//The trace requested by the DS_TRACE environment variable (nullptr if none).
+inline std::unique_ptr<TraceWriter> open_trace(char kind) {
+	const char* file_name = std::getenv("DS_TRACE");
+	if (file_name == nullptr || *file_name == '\0')
+		return std::unique_ptr<TraceWriter>();
+	return std::unique_ptr<TraceWriter>(new TraceWriter(file_name, kind));
+}
+
+}
+
+#endif /* TRACE_HPP_ */
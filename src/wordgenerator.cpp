@@ -9,12 +9,15 @@
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "string_pool.hpp"
+#include "profile.hpp"
+#include "output.hpp"
+#include "ordered_view.hpp"
 
 
 typedef ics::ArrayQueue<std::string>         WordQueue;
 typedef ics::ArraySet<std::string>           FollowSet;
 typedef ics::pair<WordQueue,FollowSet>       CorpusEntry;
-typedef ics::ArrayPriorityQueue<CorpusEntry> CorpusPQ;     //Convenient to supply gt at construction
 typedef ics::ArrayMap<WordQueue,FollowSet>   Corpus;
 
 
@@ -34,24 +37,28 @@ std::string random_in_set(const FollowSet& words) {
 //  associated with the Set of all words that follow them somewhere in the
 //  file.
 Corpus read_corpus(int os, std::ifstream &file) {
+	DS_PROFILE_PHASE(read);
 
 	Corpus answer;
 	WordQueue queue;
 	std::string line;
+	std::vector<ds::StrRef> words; //reused for every line
+	std::string i;
 
 	while (getline(file,line))
 	{
-		std::vector<std::string> words = ics::split(line," ");
-		for (auto& i : words)
+		ds::split_into(line,' ',words);
+		for (const auto& w : words)
 		{
-		  if (!(queue.size() == os))
-		  {
-			  queue.enqueue(i);
-		  }
-		  else
+		  i.assign(w.data(), w.size());   //like w.str(), but reusing i's buffer
+		  DS_PROFILE_COUNT(strings,1);
+		  DS_PROFILE_COUNT(string_bytes,w.size());
+		  if (queue.size() == os)
 		  {
 			  answer[queue].insert(i);
 			  queue.dequeue();
+			  DS_PROFILE_COUNT(lookups,1);
+			  DS_PROFILE_COUNT(inserts,1);
 		  }
 		  queue.enqueue(i);
 		}
@@ -78,23 +85,30 @@ Corpus read_corpus(int os, std::ifstream &file) {
 
 bool queue_gt(const CorpusEntry& a, const CorpusEntry& b) {
 
-	  return false;
+	  return ds::lexically_less(a.first, b.first);
 }
 
-void print_corpus(const Corpus& corpus) {
+//If top > 0, print only the first top entries (in the same order).
+void print_corpus(const Corpus& corpus, int top = 0) {
+	  DS_PROFILE_PHASE(print);
 
-	  std::cout << "\nCorpus of " << std::to_string(corpus.size()) << " entries" << std::endl;
-	  CorpusPQ sortedQueue(corpus, queue_gt);
+	  ds::out() << "\nCorpus of " << std::to_string(corpus.size()) << " entries\n";
 
 	  int minimum = std::numeric_limits<int>::max();
 	  int maximum = 0;
 
-	  for (auto& i : sortedQueue)
+	  for (const auto& i : corpus)
+	  {
+	    minimum = std::min(minimum, i.second.size());
+	    maximum = std::max(maximum, i.second.size());
+	  }
+
+	  for (const CorpusEntry* i : ds::ordered(corpus, top, queue_gt))
 	  {
-	    std::cout << "  " << i.first << " -> " << i.second << std::endl;
+	    ds::out() << "  " << i->first << " -> " << i->second << '\n';
 	  }
-	  std::cout << "Corpus of " << corpus.size() << " entries" << std::endl;
-	  std::cout << "min/max = " << minimum << "/" << maximum << std::endl;
+	  ds::out() << "Corpus of " << corpus.size() << " entries\n";
+	  ds::out() << "min/max = " << minimum << "/" << maximum << '\n';
 }
 
 
@@ -106,31 +120,49 @@ WordQueue produce_text(const Corpus& corpus, const WordQueue& start, int count)
 
 	WordQueue result (start);
 	WordQueue keys(start);
+	for (int i = 0; i < count; ++i)
+	{
+	  if (!corpus.has_key(keys))
+	  {
+		  result.enqueue("None");
+		  return result;
+	  }
+	  std::string next = random_in_set(corpus[keys]);
+	  DS_PROFILE_COUNT(lookups,2);
+	  result.enqueue(next);
+	  keys.dequeue();
+	  keys.enqueue(next);
+	}
 	return result;
 }
 
 
 
-//Prompt the user for (a) the order statistic and (b) the file storing the text.
+//Prompt the user for (a) the order statistic, (b) the file storing the text,
+//  and (c) how many Corpus entries to print (0, the default, prints them all).
 //Read the text as a Corpus and print it appropriately.
 //Prompt the user for order statistic words from the text.
 //Prompt the user for number of random words to generate
 //Call the above functions to solve the problem, and print the appropriate information
+#ifndef DS_NO_MAIN
 int main() {
+ DS_PROFILE_PROGRAM("wordgenerator");
  try {
 
 	    int os  = ics::prompt_int("Enter order statistic",2);
 	    std::ifstream corpus_file;
 	    ics::safe_open(corpus_file,"Enter file name to process","wginput1.txt");
+	    int top = ics::prompt_int("Enter how many corpus entries to print (0 for all)",0);
 	    Corpus corpus = read_corpus(os,corpus_file);
-	    print_corpus(corpus);
+	    print_corpus(corpus,top);
 
 
 
 
  } catch (ics::IcsError& e) {
-   std::cout << e.what() << std::endl;
+   ds::out() << e.what() << '\n';
  }
 
  return 0;
 }
+#endif
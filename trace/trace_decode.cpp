@@ -0,0 +1,67 @@
+#include <string>
+#include <iostream>
+#include "ics46goody.hpp"
+#include "array_set.hpp"
+#include "output.hpp"
+#include "trace.hpp"
+
+
+typedef ics::ArraySet<std::string> States;
+
+
+//Print the states of the current record the way fa/ndfa print them: one state
+//  name for an FA, an ics::ArraySet for an NDFA.
+std::string states_text(const ds::TraceReader& trace) {
+	if (trace.kind == ds::TraceWriter::kind_fa)
+		return trace.states[0];
+	States states;
+	for (const std::string& s : trace.states)
+		states.insert(s);
+	return to_string(states);
+}
+
+
+//Decode a trace written by fa or ndfa (with DS_TRACE set), printing exactly the
+//  text those programs printed for their simulations: each description, start
+//  state, input/new state and stop state line.
+//Usage: trace_decode trace-file
+int main(int argc, char* argv[]) {
+	if (argc != 2) {
+		std::cerr << "usage: trace_decode trace-file" << std::endl;
+		return 1;
+	}
+
+	try {
+		ds::TraceReader trace(argv[1]);
+		std::string lastState;
+
+		while (trace.next())
+			switch (trace.tag) {
+				case 'D':
+					ds::out() << "\nStarting new simulation with description: " << trace.line << '\n';
+					break;
+				case 'S':
+					ds::out() << "Start state = " << states_text(trace) << '\n';
+					lastState = "";
+					break;
+				case 'I':
+					lastState = states_text(trace);
+					ds::out() << " Input = " << trace.input << "; new state = " << lastState << '\n';
+					break;
+				case 'X':
+					ds::out() << " Input = " << trace.input << "; illegal input: terminated\n";
+					ds::out() << "Stop state = None\n";
+					break;
+				case 'E':
+					ds::out() << "Stop state = " << lastState << '\n';
+					break;
+			}
+
+	} catch (ics::IcsError& e) {
+		ds::out().flush();
+		std::cerr << "trace_decode: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}